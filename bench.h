@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+//reserve BENCH BenchState do_not_optimize
+
+class BenchState {
+ public:
+  BenchState(long long arg, double min_time)
+      : arg_(arg), iterations_(0), next_check_(1), bytes_(0),
+        min_time_(min_time), elapsed_(0) {}
+
+  // Returns true while the loop body should run once more. The clock
+  // starts at the first call, so setup code is not timed, and is only read
+  // at power-of-two iteration counts to keep overhead low.
+  bool run() {
+    if (iterations_ == 0) {
+      start_ = clock::now();
+    }
+    if (++iterations_ < next_check_) {
+      return true;
+    }
+    elapsed_ = clock::now() - start_;
+    if (elapsed_.count() >= min_time_) {
+      iterations_--;
+      return false;
+    }
+    next_check_ *= 2;
+    return true;
+  }
+
+  long long arg() const {
+    return arg_;
+  }
+
+  long long iterations() const {
+    return iterations_;
+  }
+
+  // Bytes processed by each iteration, reported as throughput.
+  void set_bytes(long long bytes) {
+    bytes_ = bytes;
+  }
+
+  double gb_per_second() const {
+    return bytes_ * iterations_ / elapsed_.count() / 1e9;
+  }
+
+  double ns_per_iteration() const {
+    return elapsed_.count() * 1e9 / iterations_;
+  }
+
+ private:
+  typedef std::chrono::steady_clock clock;
+
+  long long arg_, iterations_, next_check_, bytes_;
+  double min_time_;
+  clock::time_point start_;
+  std::chrono::duration<double> elapsed_;
+};
+
+template<typename T>
+void do_not_optimize(const T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct BenchCase {
+  std::string name;
+  void (*function)(BenchState&);
+  std::vector<long long> args;
+};
+
+inline std::vector<BenchCase>& bench_registry() {
+  static std::vector<BenchCase> registry;
+  return registry;
+}
+
+struct BenchRegister {
+  BenchRegister(const char* name, void (*function)(BenchState&),
+                std::vector<long long> args) {
+    BenchCase c = {name, function, args};
+    bench_registry().push_back(c);
+  }
+};
+
+#define BENCH(name, ...) \
+  void bench_##name(BenchState& state); \
+  static BenchRegister register_##name(#name, bench_##name, {__VA_ARGS__}); \
+  void bench_##name(BenchState& state)
+
+// Command line: --filter=substring runs only matching benchmarks,
+// --format=console|csv|json picks the report, --min_time=seconds sets the
+// time per measurement and --repetitions=n keeps the fastest of n runs.
+// CSV output from several binaries can be concatenated; bench_compare.py
+// reads either format.
+struct BenchOptions {
+  BenchOptions() : filter(""), format("console"), min_time(0.2),
+                   repetitions(1) {}
+  std::string filter, format;
+  double min_time;
+  int repetitions;
+};
+
+inline bool bench_flag(const char* arg, const char* name, std::string& value) {
+  std::string prefix = std::string("--") + name + "=";
+  if (prefix.compare(0, prefix.size(), arg, prefix.size()) != 0) {
+    return false;
+  }
+  value = arg + prefix.size();
+  return true;
+}
+
+inline std::string bench_suite(const char* path) {
+  std::string suite(path);
+  size_t slash = suite.rfind('/');
+  return slash == std::string::npos ? suite : suite.substr(slash + 1);
+}
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  for (int i = 1; i < argc; i++) {
+    std::string value;
+    if (bench_flag(argv[i], "filter", value)) {
+      options.filter = value;
+    } else if (bench_flag(argv[i], "format", value)) {
+      options.format = value;
+    } else if (bench_flag(argv[i], "min_time", value)) {
+      options.min_time = atof(value.c_str());
+    } else if (bench_flag(argv[i], "repetitions", value)) {
+      options.repetitions = std::max(1, atoi(value.c_str()));
+    } else {
+      fprintf(stderr, "usage: %s [--filter=substring] "
+              "[--format=console|csv|json] [--min_time=seconds] "
+              "[--repetitions=n]\n", argv[0]);
+      return 1;
+    }
+  }
+  std::string suite = bench_suite(argv[0]);
+  bool first = true;
+  if (options.format == "csv") {
+    printf("suite,name,arg,iterations,ns_per_iteration,gb_per_second\n");
+  } else if (options.format == "json") {
+    printf("{\n  \"suite\": \"%s\",\n  \"benchmarks\": [", suite.c_str());
+  }
+  for (unsigned i = 0; i < bench_registry().size(); i++) {
+    const BenchCase& c = bench_registry()[i];
+    for (unsigned j = 0; j < c.args.size(); j++) {
+      std::string name = c.name + "/" + std::to_string(c.args[j]);
+      if (name.find(options.filter) == std::string::npos) {
+        continue;
+      }
+      BenchState best(c.args[j], options.min_time);
+      for (int k = 0; k < options.repetitions; k++) {
+        BenchState state(c.args[j], options.min_time);
+        c.function(state);
+        if (k == 0 || state.ns_per_iteration() < best.ns_per_iteration()) {
+          best = state;
+        }
+      }
+      if (options.format == "csv") {
+        printf("%s,%s,%lld,%lld,%.3f,%.6f\n", suite.c_str(), c.name.c_str(),
+               c.args[j], best.iterations(), best.ns_per_iteration(),
+               best.gb_per_second());
+      } else if (options.format == "json") {
+        printf("%s\n    {\"name\": \"%s\", \"arg\": %lld, "
+               "\"iterations\": %lld, \"ns_per_iteration\": %.3f, "
+               "\"gb_per_second\": %.6f}", first ? "" : ",", c.name.c_str(),
+               c.args[j], best.iterations(), best.ns_per_iteration(),
+               best.gb_per_second());
+      } else {
+        printf("%-40s %12lld %14.1f ns", name.c_str(),
+               best.iterations(), best.ns_per_iteration());
+        if (best.gb_per_second() > 0) {
+          printf(" %8.3f GB/s", best.gb_per_second());
+        }
+        printf("\n");
+      }
+      fflush(stdout);
+      first = false;
+    }
+  }
+  if (options.format == "json") {
+    printf("\n  ]\n}\n");
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Compares two benchmark runs and flags regressions.
+
+Each run is the output of one or more *_bench binaries in --format=csv
+(concatenated) or --format=json. Benchmarks are matched by suite, name and
+argument; a benchmark regresses when its time per iteration grows by more
+than the threshold. Exits with status 1 if any benchmark regressed.
+
+  make bench.csv && mv bench.csv base.csv
+  ... change something ...
+  make bench.csv && ./bench_compare.py base.csv bench.csv
+"""
+
+import argparse
+import csv
+import json
+import sys
+
+
+def read_csv(text):
+  results = {}
+  for row in csv.reader(text.splitlines()):
+    if not row or row[0] == "suite":
+      continue
+    suite, name, arg, _, ns = row[:5]
+    results[(suite, name, int(arg))] = float(ns)
+  return results
+
+
+def read_json(text):
+  results = {}
+  decoder = json.JSONDecoder()
+  pos = 0
+  while pos < len(text):
+    if text[pos].isspace():
+      pos += 1
+      continue
+    run, pos = decoder.raw_decode(text, pos)
+    for b in run["benchmarks"]:
+      key = (run["suite"], b["name"], int(b["arg"]))
+      results[key] = float(b["ns_per_iteration"])
+  return results
+
+
+def read_run(path):
+  with open(path) as f:
+    text = f.read()
+  if text.lstrip().startswith("{"):
+    return read_json(text)
+  return read_csv(text)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+  parser.add_argument("base", help="results of the reference build")
+  parser.add_argument("new", help="results of the build under test")
+  parser.add_argument("--threshold", type=float, default=0.10,
+                      help="relative slowdown that counts as a regression")
+  args = parser.parse_args()
+
+  base = read_run(args.base)
+  new = read_run(args.new)
+  regressions = 0
+  for key in sorted(set(base) | set(new)):
+    label = "%s %s/%d" % key
+    if key not in new:
+      print("%-50s %12s" % (label, "missing"))
+      continue
+    if key not in base:
+      print("%-50s %12s %12.1f ns" % (label, "new", new[key]))
+      continue
+    change = new[key] / base[key] - 1
+    flag = ""
+    if change > args.threshold:
+      flag = "  REGRESSION"
+      regressions += 1
+    elif change < -args.threshold:
+      flag = "  faster"
+    print("%-50s %12.1f %12.1f ns %+7.1f%%%s" % (
+        label, base[key], new[key], 100 * change, flag))
+  if regressions:
+    print("%d benchmark(s) regressed by more than %.0f%%" % (
+        regressions, 100 * args.threshold))
+    return 1
+  return 0
+
+
+if __name__ == "__main__":
+  sys.exit(main())
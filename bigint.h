@@ -1,6 +1,7 @@
 #include <vector>
 #include <cstring>
 #include <string>
+#include "instrument.h"
 
 //reserve bigint
 
@@ -14,6 +15,7 @@ template <int B>
 class _bigint {
  public:
   static const int B10 = P10<B>::P;
+  typedef std::vector<int, INSTRUMENT_ALLOCATOR(int, Bigint)> limbs;
   _bigint() : digits_(1, 0), size_(1) {}
   _bigint(const char* p) {
     build(p);
@@ -23,11 +25,14 @@ class _bigint {
   _bigint(const std::string s) {
     build(s.c_str());
   }
-  _bigint(int x) {
-    while (x) {
+  _bigint(int x) : _bigint(static_cast<long long>(x)) {
+  }
+
+  _bigint(long long x) {
+    do {
       digits_.push_back(x % B10);
       x /= B10;
-    }
+    } while (x);
     size_ = digits_.size();
   }
   operator std::string() const {
@@ -123,6 +128,7 @@ class _bigint {
     return ans;
   }
   _bigint<B> operator*(const _bigint<B>& b) const {
+    INSTRUMENT_TIMER("bigint.multiply");
     // TODO: fix this.
     //if (std::max(size_, b.size_) > 50) {
     //  return karatsuba(b);
@@ -155,6 +161,15 @@ class _bigint {
   int get(int i) const {
     return i >= size_ ? 0 : digits_[i];
   }
+  int size() const {
+    return size_;
+  }
+  // Takes the little-endian limbs, each in [0, B10).
+  void assign(limbs& digits) {
+    digits_.swap(digits);
+    size_ = digits_.size();
+    trim();
+  }
  private:
   void build(const char* p) {
     int n = strlen(p);
@@ -187,6 +202,7 @@ class _bigint {
   }
   void divmul(int a, int b, int carry, 
               int& outlow, int& outhigh, int modulus) const {
+    INSTRUMENT_COUNT("bigint.divmul", 1);
     asm volatile (
       "imull %%ebx \n\t"
       "addl %%ecx,%%eax \n\t"
@@ -218,7 +234,7 @@ class _bigint {
       ans.digits_[i - a] = get(i);
     return ans;
   }
-  std::vector<int> digits_;
+  limbs digits_;
   int size_;
 };
 
@@ -0,0 +1,75 @@
+#include <string>
+#include "bench.h"
+#include "bigint.h"
+
+// Decimal string with the given number of digits and no leading zero.
+std::string random_digits(int digits, unsigned seed) {
+  std::string s(digits, '0');
+  for (int i = 0; i < digits; i++) {
+    seed = seed * 1103515245 + 12345;
+    s[i] = '0' + (seed >> 16) % 10;
+  }
+  s[0] = '1' + (seed >> 16) % 9;
+  return s;
+}
+
+BENCH(Add, 100, 1000, 10000) {
+  bigint a(random_digits(state.arg(), 1)), b(random_digits(state.arg(), 2));
+  while (state.run()) {
+    do_not_optimize(a + b);
+  }
+}
+
+BENCH(Subtract, 100, 1000, 10000) {
+  bigint a(random_digits(state.arg(), 1)), b(random_digits(state.arg(), 2));
+  if (a < b) {
+    std::swap(a, b);
+  }
+  while (state.run()) {
+    do_not_optimize(a - b);
+  }
+}
+
+BENCH(Multiply, 100, 1000, 10000) {
+  bigint a(random_digits(state.arg(), 1)), b(random_digits(state.arg(), 2));
+  while (state.run()) {
+    do_not_optimize(a * b);
+  }
+}
+
+BENCH(DivideInt, 100, 1000, 10000) {
+  bigint a(random_digits(state.arg(), 1));
+  while (state.run()) {
+    do_not_optimize(a / 999999937);
+  }
+}
+
+BENCH(ModInt, 100, 1000, 10000) {
+  bigint a(random_digits(state.arg(), 1));
+  while (state.run()) {
+    do_not_optimize(a % 999983);
+  }
+}
+
+BENCH(Power, 100, 1000) {
+  bigint a(random_digits(9, 1));
+  while (state.run()) {
+    do_not_optimize(a.power(state.arg()));
+  }
+}
+
+BENCH(FromString, 100, 1000, 10000) {
+  std::string s = random_digits(state.arg(), 1);
+  state.set_bytes(s.size());
+  while (state.run()) {
+    do_not_optimize(bigint(s));
+  }
+}
+
+BENCH(ToString, 100, 1000, 10000) {
+  bigint a(random_digits(state.arg(), 1));
+  state.set_bytes(state.arg());
+  while (state.run()) {
+    do_not_optimize(std::string(a));
+  }
+}
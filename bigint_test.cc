@@ -24,6 +24,10 @@ TEST(BigintTest, FromInt) {
   EXPECT_EQ("123", static_cast<string>(_bigint<1>(123)));
   EXPECT_EQ("54321", static_cast<string>(_bigint<1>(54321)));
   EXPECT_EQ("12345", static_cast<string>(_bigint<2>(12345)));
+  EXPECT_EQ("0", static_cast<string>(_bigint<9>(0)));
+  EXPECT_EQ("4294967311", static_cast<string>(bigint(4294967311LL)));
+  EXPECT_EQ("9223372036854775807",
+            static_cast<string>(bigint(9223372036854775807LL)));
 }
 
 TEST(BigintTest, InputOutput) {
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+//reserve binomial binomial_table factorial_table permutations multinomial
+
+// Pascal's triangle up to row N - 1, built by the compiler. Works for any
+// literal type with constexpr addition, e.g. unsigned long long (exact up
+// to N = 68) or modint for any modulus, prime or not.
+template<typename T, int N>
+class binomial_table {
+ public:
+  constexpr binomial_table() : table_() {
+    for (int n = 0; n < N; n++) {
+      table_[n][0] = T(1);
+      for (int k = 1; k <= n; k++) {
+        table_[n][k] = table_[n - 1][k - 1] + table_[n - 1][k];
+      }
+    }
+  }
+
+  // C(n, k) for 0 <= n < N; zero when k is out of [0, n].
+  constexpr T operator()(int n, int k) const {
+    return k < 0 || k > n ? T(0) : table_[n][k];
+  }
+
+ private:
+  T table_[N][N];
+};
+
+// Factorials and inverse factorials below N, built by the compiler, for
+// C(n, k) = n! / (k! (n - k)!) in two multiplications. T is a modint with
+// a prime modulus larger than N - 1; only one inverse is computed, the
+// rest follow from 1/(i - 1)! = i / i!.
+template<typename T, int N>
+class factorial_table {
+ public:
+  constexpr factorial_table() : factorial_(), inverse_() {
+    factorial_[0] = T(1);
+    for (int i = 1; i < N; i++) {
+      factorial_[i] = factorial_[i - 1] * T(i);
+    }
+    inverse_[N - 1] = factorial_[N - 1].inverse();
+    for (int i = N - 1; i > 0; i--) {
+      inverse_[i - 1] = inverse_[i] * T(i);
+    }
+  }
+
+  constexpr const T& factorial(int n) const {
+    return factorial_[n];
+  }
+
+  constexpr const T& inverse_factorial(int n) const {
+    return inverse_[n];
+  }
+
+  // C(n, k) for 0 <= n < N; zero when k is out of [0, n].
+  constexpr T operator()(int n, int k) const {
+    return k < 0 || k > n ? T(0) :
+        factorial_[n] * inverse_[k] * inverse_[n - k];
+  }
+
+ private:
+  T factorial_[N], inverse_[N];
+};
+
+// Binomial coefficients modulo a prime M, for T = modint<M>. Factorials
+// and inverse factorials grow on demand, doubling each time with a single
+// inverse; then C(n, k), permutations and multinomials cost O(1). For
+// n >= M, C(n, k) goes through Lucas' theorem on the base-M digits, so
+// the tables never need more than M entries. factorial(n) and
+// permutations are zero once the product reaches a multiple of M;
+// inverse_factorial(n) and inverse(n) require n < M.
+template<typename T>
+class binomial {
+ public:
+  explicit binomial(int n = 0) : mod_(int(T(-1)) + 1LL) {
+    factorial_.push_back(T(1));
+    inverse_.push_back(T(1));
+    reserve(n);
+  }
+
+  // Tables for 0..n, capped at M - 1.
+  void reserve(long long n) {
+    int last = int(std::min(n, mod_ - 1));
+    int size = factorial_.size();
+    if (last < size) {
+      return;
+    }
+    last = int(std::min(std::max<long long>(last, 2LL * size - 1), mod_ - 1));
+    factorial_.resize(last + 1);
+    inverse_.resize(last + 1);
+    for (int i = size; i <= last; i++) {
+      factorial_[i] = factorial_[i - 1] * T(i);
+    }
+    inverse_[last] = factorial_[last].inverse();
+    for (int i = last; i > size; i--) {
+      inverse_[i - 1] = inverse_[i] * T(i);
+    }
+  }
+
+  T factorial(int n) {
+    if (n >= mod_) {
+      return T(0);
+    }
+    reserve(n);
+    return factorial_[n];
+  }
+
+  const T& inverse_factorial(int n) {
+    assert(n < mod_);
+    reserve(n);
+    return inverse_[n];
+  }
+
+  // 1 / n for 0 < n < M.
+  T inverse(int n) {
+    assert(0 < n && n < mod_);
+    reserve(n);
+    return inverse_[n] * factorial_[n - 1];
+  }
+
+  // C(n, k), zero when k is out of [0, n].
+  T operator()(long long n, long long k) {
+    if (k < 0 || k > n) {
+      return T(0);
+    }
+    if (n < mod_) {
+      reserve(n);
+      return choose(n, k);
+    }
+    T ans(1);
+    for (; n && ans != T(0); n /= mod_, k /= mod_) {
+      long long ni = n % mod_, ki = k % mod_;
+      if (ki > ni) {
+        return T(0);
+      }
+      reserve(ni);
+      ans = ans * choose(ni, ki);
+    }
+    return ans;
+  }
+
+  // C(n, k) for every query (n, k). The tables grow once, up front.
+  void operator()(const std::vector<std::pair<long long, long long> >& queries,
+                  std::vector<T>& out) {
+    long long top = 0;
+    for (unsigned i = 0; i < queries.size(); i++) {
+      if (queries[i].first < mod_) {
+        top = std::max(top, queries[i].first);
+      }
+    }
+    reserve(top);
+    out.resize(queries.size());
+    for (unsigned i = 0; i < queries.size(); i++) {
+      long long n = queries[i].first, k = queries[i].second;
+      out[i] = k < 0 || k > n ? T(0) :
+          n < mod_ ? choose(n, k) : (*this)(n, k);
+    }
+  }
+
+  // n! / (n - k)!, zero when k is out of [0, n]. For n >= M the k factors
+  // either cover a multiple of M or match those of n mod M.
+  T permutations(int n, int k) {
+    if (k < 0 || k > n) {
+      return T(0);
+    }
+    if (n >= mod_) {
+      return k > n % mod_ ? T(0) : permutations(int(n % mod_), k);
+    }
+    reserve(n);
+    return factorial_[n] * inverse_[n - k];
+  }
+
+  // (k1 + k2 + ...)! / (k1! k2! ...). A sum of M or more is computed as
+  // the product of C(k1 + ... + ki, ki), each through Lucas.
+  T multinomial(const std::vector<int>& k) {
+    long long n = 0;
+    for (unsigned i = 0; i < k.size(); i++) {
+      n += k[i];
+    }
+    T ans(1);
+    if (n < mod_) {
+      reserve(n);
+      ans = factorial_[n];
+      for (unsigned i = 0; i < k.size(); i++) {
+        ans = ans * inverse_[k[i]];
+      }
+    } else {
+      long long partial = 0;
+      for (unsigned i = 0; i < k.size(); i++) {
+        partial += k[i];
+        ans = ans * (*this)(partial, k[i]);
+      }
+    }
+    return ans;
+  }
+
+ private:
+  T choose(long long n, long long k) const {
+    return factorial_[n] * inverse_[k] * inverse_[n - k];
+  }
+
+  long long mod_;
+  std::vector<T> factorial_, inverse_;
+};
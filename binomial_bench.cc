@@ -0,0 +1,68 @@
+#include <utility>
+#include <vector>
+#include "bench.h"
+#include "modint.h"
+#include "binomial.h"
+
+typedef modint<1000000007> mint;
+
+// Factorials with one inverse() per element, as done by hand.
+BENCH(PerElementInverse, 1 << 10, 1 << 16, 1 << 20) {
+  while (state.run()) {
+    std::vector<mint> factorial(state.arg()), inverse(state.arg());
+    factorial[0] = inverse[0] = mint(1);
+    for (int i = 1; i < state.arg(); i++) {
+      factorial[i] = factorial[i - 1] * mint(i);
+      inverse[i] = factorial[i].inverse();
+    }
+    do_not_optimize(inverse);
+  }
+}
+
+BENCH(Reserve, 1 << 10, 1 << 16, 1 << 20) {
+  while (state.run()) {
+    binomial<mint> binom(state.arg() - 1);
+    do_not_optimize(binom);
+  }
+}
+
+BENCH(Choose, 1 << 10, 1 << 20) {
+  binomial<mint> binom(state.arg());
+  unsigned seed = 12345;
+  while (state.run()) {
+    seed = seed * 1103515245 + 12345;
+    int n = (seed >> 8) % state.arg();
+    do_not_optimize(binom(n, n / 3));
+  }
+}
+
+BENCH(ChooseBatch, 1 << 10, 1 << 20) {
+  std::vector<std::pair<long long, long long> > queries(1 << 10);
+  unsigned seed = 12345;
+  for (unsigned i = 0; i < queries.size(); i++) {
+    seed = seed * 1103515245 + 12345;
+    int n = (seed >> 8) % state.arg();
+    queries[i] = std::make_pair(n, n / 3);
+  }
+  std::vector<mint> out;
+  binomial<mint> binom(state.arg());
+  while (state.run()) {
+    binom(queries, out);
+    do_not_optimize(out);
+  }
+}
+
+BENCH(Lucas, 7, 65537) {
+  typedef modint<65537> small;
+  binomial<modint<7> > binom7;
+  binomial<small> binom;
+  long long n = 1000000000000000000LL;
+  while (state.run()) {
+    if (state.arg() == 7) {
+      do_not_optimize(binom7(n, n / 3));
+    } else {
+      do_not_optimize(binom(n, n / 3));
+    }
+    n++;
+  }
+}
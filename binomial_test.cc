@@ -0,0 +1,124 @@
+#include "gtest/gtest.h"
+#include "modint.h"
+#include "binomial.h"
+
+typedef modint<1000000007> mint;
+
+TEST(BinomialTableTest, Exact) {
+  constexpr static binomial_table<unsigned long long, 68> table;
+  static_assert(table(4, 2) == 6, "C(4, 2)");
+  EXPECT_EQ(1u, table(0, 0));
+  EXPECT_EQ(0u, table(5, 6));
+  EXPECT_EQ(0u, table(5, -1));
+  EXPECT_EQ(252u, table(10, 5));
+  EXPECT_EQ(14226520737620288370ULL, table(67, 33));
+}
+
+TEST(BinomialTableTest, CompositeModulus) {
+  constexpr static binomial_table<modint<12>, 20> table;
+  binomial_table<unsigned long long, 20> exact;
+  for (int n = 0; n < 20; n++) {
+    for (int k = 0; k <= n; k++) {
+      EXPECT_EQ(int(exact(n, k) % 12), table(n, k));
+    }
+  }
+}
+
+TEST(FactorialTableTest, Modint) {
+  constexpr static factorial_table<mint, 1000> table;
+  static_assert(table.factorial(5) == 120, "5!");
+  static_assert(table(10, 3) == 120, "C(10, 3)");
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(1, table.factorial(i) * table.inverse_factorial(i));
+  }
+  binomial_table<mint, 100> pascal;
+  for (int n = 0; n < 100; n++) {
+    for (int k = -1; k <= n + 1; k++) {
+      EXPECT_EQ(pascal(n, k), table(n, k));
+    }
+  }
+}
+
+TEST(BinomialTest, LazyGrowth) {
+  constexpr static factorial_table<mint, 1000> table;
+  binomial<mint> binom;
+  EXPECT_EQ(table.factorial(10), binom.factorial(10));
+  EXPECT_EQ(table.factorial(999), binom.factorial(999));
+  EXPECT_EQ(table.inverse_factorial(500), binom.inverse_factorial(500));
+  EXPECT_EQ(table.inverse_factorial(3), binom.inverse_factorial(3));
+  for (int n = 1; n < 1000; n++) {
+    EXPECT_EQ(1, binom.inverse(n) * mint(n));
+  }
+  EXPECT_EQ(table(999, 400), binom(999, 400));
+  EXPECT_EQ(0, binom(10, 11));
+  EXPECT_EQ(0, binom(10, -1));
+}
+
+TEST(BinomialTest, PermutationsAndMultinomial) {
+  binomial<mint> binom;
+  EXPECT_EQ(1, binom.permutations(5, 0));
+  EXPECT_EQ(60, binom.permutations(5, 3));
+  EXPECT_EQ(120, binom.permutations(5, 5));
+  EXPECT_EQ(0, binom.permutations(5, 6));
+  int k[] = {2, 3, 4};
+  EXPECT_EQ(1260, binom.multinomial(std::vector<int>(k, k + 3)));
+  EXPECT_EQ(1, binom.multinomial(std::vector<int>()));
+}
+
+TEST(BinomialTest, Lucas) {
+  typedef modint<7> m7;
+  binomial<m7> binom;
+  binomial_table<unsigned long long, 60> exact;
+  for (int n = 0; n < 60; n++) {
+    for (int k = 0; k <= n; k++) {
+      EXPECT_EQ(int(exact(n, k) % 7), binom(n, k));
+    }
+  }
+  // 10^18 in base 7 against 5 * 10^17, digit by digit.
+  long long n = 1000000000000000000LL, k = 500000000000000000LL;
+  int ans = 1;
+  for (long long a = n, b = k; a; a /= 7, b /= 7) {
+    ans = ans * exact(a % 7, b % 7) % 7;
+  }
+  EXPECT_EQ(ans, binom(n, k));
+  binomial<mint> big;
+  EXPECT_EQ(10, big(1000000007LL + 5, 3));
+  EXPECT_EQ(0, big(1000000007LL, 3));
+  // Multinomial {3, 4} = C(7, 3) = 35, which is 0 modulo 5 and 7.
+  int k34[] = {3, 4};
+  EXPECT_EQ(0, binom.multinomial(std::vector<int>(k34, k34 + 2)));
+  EXPECT_EQ(0, binomial<modint<5> >().multinomial(
+      std::vector<int>(k34, k34 + 2)));
+  EXPECT_EQ(35 % 11, binomial<modint<11> >().multinomial(
+      std::vector<int>(k34, k34 + 2)));
+}
+
+TEST(BinomialTest, PastModulus) {
+  typedef modint<7> m7;
+  binomial<m7> binom;
+  EXPECT_EQ(m7(720), binom.factorial(6));
+  EXPECT_EQ(0, binom.factorial(7));
+  EXPECT_EQ(0, binom.factorial(100));
+  EXPECT_EQ(1, binom.inverse_factorial(6) * binom.factorial(6));
+  EXPECT_EQ(0, binom.permutations(7, 1));
+  EXPECT_EQ(0, binom.permutations(9, 3));
+  // 10 * 9 = 90, which is 6 modulo 7.
+  EXPECT_EQ(6, binom.permutations(10, 2));
+  EXPECT_EQ(1, binom.permutations(7, 0));
+}
+
+TEST(BinomialTest, Batch) {
+  binomial<mint> binom, single;
+  std::vector<std::pair<long long, long long> > queries;
+  for (int i = 0; i < 1000; i++) {
+    queries.push_back(std::make_pair(i * 37 % 5000, i * 91 % 3000 - 10));
+  }
+  queries.push_back(std::make_pair(1000000007LL * 3 + 4, 1000000007LL + 2));
+  std::vector<mint> out;
+  binom(queries, out);
+  ASSERT_EQ(queries.size(), out.size());
+  for (unsigned i = 0; i < queries.size(); i++) {
+    EXPECT_EQ(single(queries[i].first, queries[i].second), out[i]);
+  }
+  EXPECT_EQ(18, out.back());
+}
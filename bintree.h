@@ -1,37 +1,565 @@
-// reserve BinaryTree insert traverse root left right Node
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <thread>
+#include <vector>
 
-template<class T>
+// reserve BinaryTree NodeArena insert traverse relayout root left right Node
+
+// Chunked node storage addressed by 32-bit indices. Chunks never move, so
+// references to nodes stay valid while the arena grows, and everything is
+// released at once when the arena is cleared or destroyed.
+template<class Node, int SHIFT = 12>
+class NodeArena {
+ public:
+  typedef unsigned index;
+
+  NodeArena() : size_(0) {}
+
+  NodeArena(const NodeArena& other) : size_(0) {
+    for (index i = 0; i < other.size_; i++) {
+      allocate(other[i]);
+    }
+    free_ = other.free_;
+  }
+
+  ~NodeArena() {
+    clear();
+  }
+
+  NodeArena& operator=(NodeArena other) {
+    swap(other);
+    return *this;
+  }
+
+  // Replaces the contents with n copies of node.
+  void resize(index n, const Node& node) {
+    clear();
+    for (index i = 0; i < n; i++) {
+      allocate(node);
+    }
+  }
+
+  index allocate(const Node& node) {
+    if (!free_.empty()) {
+      index i = free_.back();
+      free_.pop_back();
+      (*this)[i].~Node();
+      new (&(*this)[i]) Node(node);
+      return i;
+    }
+    if ((size_ >> SHIFT) == chunks_.size()) {
+      void* chunk = operator new(sizeof(Node) << SHIFT);
+      chunks_.push_back(static_cast<Node*>(chunk));
+    }
+    new (&(*this)[size_]) Node(node);
+    return size_++;
+  }
+
+  Node& operator[](index i) {
+    return chunks_[i >> SHIFT][i & MASK];
+  }
+
+  const Node& operator[](index i) const {
+    return chunks_[i >> SHIFT][i & MASK];
+  }
+
+  // Released nodes stay constructed until they are reused or cleared.
+  void release(index i) {
+    free_.push_back(i);
+  }
+
+  // Number of live nodes.
+  index size() const {
+    return size_ - free_.size();
+  }
+
+  // Upper bound on the indices handed out so far.
+  index slots() const {
+    return size_;
+  }
+
+  void clear() {
+    for (index i = 0; i < size_; i++) {
+      (*this)[i].~Node();
+    }
+    for (unsigned i = 0; i < chunks_.size(); i++) {
+      operator delete(chunks_[i]);
+    }
+    chunks_.clear();
+    free_.clear();
+    size_ = 0;
+  }
+
+  void swap(NodeArena& other) {
+    chunks_.swap(other.chunks_);
+    free_.swap(other.free_);
+    std::swap(size_, other.size_);
+  }
+
+ private:
+  static const index MASK = (1U << SHIFT) - 1;
+
+  std::vector<Node*> chunks_;
+  index size_;
+  std::vector<index> free_;
+};
+
+// Balancing policies for BinaryTree. refresh() recomputes the policy data
+// of a node from its children, and fix() restores the invariant at a node
+// whose subtrees are already valid, returning the new subtree root. built()
+// sets the policy data of a node of a bulk-loaded tree given its height.
+struct Unbalanced {
+  template<class Tree>
+  static void init(Tree& tree, typename Tree::Node& node) {}
+
+  template<class Tree>
+  static void built(typename Tree::Node& node, unsigned i, int height) {}
+
+  template<class Tree>
+  static void refresh(Tree& tree, typename Tree::index i) {}
+
+  template<class Tree>
+  static typename Tree::index fix(Tree& tree, typename Tree::index i) {
+    return i;
+  }
+};
+
+// AVL tree, aux holds the height of the subtree.
+struct AVL {
+  template<class Tree>
+  static void init(Tree& tree, typename Tree::Node& node) {
+    node.aux = 1;
+  }
+
+  template<class Tree>
+  static void built(typename Tree::Node& node, unsigned i, int height) {
+    node.aux = height;
+  }
+
+  template<class Tree>
+  static void refresh(Tree& tree, typename Tree::index i) {
+    typename Tree::Node& node = tree.nodes_[i];
+    node.aux = 1 + std::max(height(tree, node.left), height(tree, node.right));
+  }
+
+  template<class Tree>
+  static typename Tree::index fix(Tree& tree, typename Tree::index i) {
+    typename Tree::Node& node = tree.nodes_[i];
+    int balance = height(tree, node.left) - height(tree, node.right);
+    if (balance > 1) {
+      const typename Tree::Node& left = tree.nodes_[node.left];
+      if (height(tree, left.left) < height(tree, left.right)) {
+        node.left = tree.rotate_left(node.left);
+      }
+      return tree.rotate_right(i);
+    }
+    if (balance < -1) {
+      const typename Tree::Node& right = tree.nodes_[node.right];
+      if (height(tree, right.right) < height(tree, right.left)) {
+        node.right = tree.rotate_right(node.right);
+      }
+      return tree.rotate_left(i);
+    }
+    return i;
+  }
+
+ private:
+  template<class Tree>
+  static int height(const Tree& tree, typename Tree::index i) {
+    return i == Tree::NIL ? 0 : tree.nodes_[i].aux;
+  }
+};
+
+// Treap, aux holds a random heap priority.
+struct Treap {
+  template<class Tree>
+  static void init(Tree& tree, typename Tree::Node& node) {
+    node.aux = tree.random();
+  }
+
+  // Nodes of height h get priorities in [2^32 - 2^(33-h), 2^32 - 2^(32-h)),
+  // which is where they would land in a random treap, so parents always
+  // outrank children. The offset is a hash of the index because threads
+  // can't share the generator.
+  template<class Tree>
+  static void built(typename Tree::Node& node, unsigned i, int height) {
+    unsigned long long width = 1ULL << std::max(0, 32 - height);
+    node.aux = (1ULL << 32) - 2 * width + (i * 2654435761U) % width;
+  }
+
+  template<class Tree>
+  static void refresh(Tree& tree, typename Tree::index i) {}
+
+  template<class Tree>
+  static typename Tree::index fix(Tree& tree, typename Tree::index i) {
+    const typename Tree::Node& node = tree.nodes_[i];
+    if (node.left != Tree::NIL && tree.nodes_[node.left].aux > node.aux) {
+      return tree.rotate_right(i);
+    }
+    if (node.right != Tree::NIL && tree.nodes_[node.right].aux > node.aux) {
+      return tree.rotate_left(i);
+    }
+    return i;
+  }
+};
+
+template<class T, class Balance = Unbalanced>
 class BinaryTree {
  public:
+  typedef unsigned index;
+  static const index NIL = ~0U;
+
   struct Node {
     T value;
-    Node *left, *right;
-    Node(const T& v) : value(v), left(NULL), right(NULL) {}
+    index left, right;
+    unsigned size, aux;
+    Node(const T& v) : value(v), left(NIL), right(NIL), size(1), aux(0) {}
   };
-  Node *root;
-  BinaryTree() : root(NULL) {}
+
+  enum Layout { PREORDER, BFS };
+
+  index root;
+  BinaryTree() : root(NIL), seed_(2463534242U) {}
+
   void insert(const T& value) {
-    Node **current = &root;
-    while (*current != NULL) {
-      if (value < (*current)->value)
-        current = &(*current)->left;
+    path_.clear();
+    index *current = &root;
+    while (*current != NIL) {
+      path_.push_back(*current);
+      Node& node = nodes_[*current];
+      if (value < node.value)
+        current = &node.left;
+      else
+        current = &node.right;
+    }
+    Node node(value);
+    Balance::init(*this, node);
+    *current = nodes_.allocate(node);
+    path_.push_back(*current);
+    rebalance(path_.size() - 1);
+  }
+
+  // Removes one element equal to value, returns false if there is none.
+  bool erase(const T& value) {
+    path_.clear();
+    index i = root;
+    while (i != NIL) {
+      path_.push_back(i);
+      Node& node = nodes_[i];
+      if (value < node.value)
+        i = node.left;
+      else if (node.value < value)
+        i = node.right;
+      else
+        break;
+    }
+    if (i == NIL) {
+      return false;
+    }
+    if (nodes_[i].left != NIL && nodes_[i].right != NIL) {
+      index next = nodes_[i].right;
+      path_.push_back(next);
+      while (nodes_[next].left != NIL) {
+        next = nodes_[next].left;
+        path_.push_back(next);
+      }
+      std::swap(nodes_[i].value, nodes_[next].value);
+      i = next;
+    }
+    const Node& node = nodes_[i];
+    link(path_.size() - 1) = node.left != NIL ? node.left : node.right;
+    nodes_.release(i);
+    path_.pop_back();
+    if (!path_.empty()) {
+      rebalance(path_.size() - 1);
+    }
+    return true;
+  }
+
+  // Index of a node holding value, or NIL.
+  index find(const T& value) const {
+    index i = root;
+    while (i != NIL) {
+      const Node& node = nodes_[i];
+      if (value < node.value)
+        i = node.left;
+      else if (node.value < value)
+        i = node.right;
       else
-        current = &(*current)->right;
+        return i;
+    }
+    return NIL;
+  }
+
+  // The k-th smallest element, 0 <= k < size().
+  const T& kth(int k) const {
+    index i = root;
+    while (true) {
+      const Node& node = nodes_[i];
+      int left = size_of(node.left);
+      if (k < left) {
+        i = node.left;
+      } else if (k == left) {
+        return node.value;
+      } else {
+        k -= left + 1;
+        i = node.right;
+      }
+    }
+  }
+
+  // Number of elements strictly smaller than value.
+  int rank(const T& value) const {
+    int ans = 0;
+    index i = root;
+    while (i != NIL) {
+      const Node& node = nodes_[i];
+      if (node.value < value) {
+        ans += size_of(node.left) + 1;
+        i = node.right;
+      } else {
+        i = node.left;
+      }
     }
-    *current = new Node(value);
+    return ans;
   }
+
+  Node& node(index i) {
+    return nodes_[i];
+  }
+
+  const Node& node(index i) const {
+    return nodes_[i];
+  }
+
+  int size() const {
+    return nodes_.size();
+  }
+
+  int depth() const {
+    int ans = 0;
+    std::vector<std::pair<index, int> > stack;
+    if (root != NIL) stack.push_back(std::make_pair(root, 1));
+    while (!stack.empty()) {
+      index i = stack.back().first;
+      int d = stack.back().second;
+      stack.pop_back();
+      ans = std::max(ans, d);
+      const Node& node = nodes_[i];
+      if (node.left != NIL) stack.push_back(std::make_pair(node.left, d + 1));
+      if (node.right != NIL) stack.push_back(std::make_pair(node.right, d + 1));
+    }
+    return ans;
+  }
+
+  void clear() {
+    nodes_.clear();
+    root = NIL;
+  }
+
+  // Preorder traversal, iterative so that degenerate trees are safe.
   template<typename Q>
   void traverse(Q callback) {
-    traverse_(root, callback);
+    std::vector<index> stack;
+    if (root != NIL) stack.push_back(root);
+    while (!stack.empty()) {
+      Node& node = nodes_[stack.back()];
+      stack.pop_back();
+      callback(node.value);
+      if (node.right != NIL) stack.push_back(node.right);
+      if (node.left != NIL) stack.push_back(node.left);
+    }
   }
- private:
+
+  // Visits the values in sorted order.
   template<typename Q>
-  void traverse_(Node* node, Q callback) {
-    if (node == NULL) return;
-    callback(node->value);
-    traverse_(node->left, callback);
-    traverse_(node->right, callback);
+  void inorder(Q callback) const {
+    std::vector<index> stack;
+    index i = root;
+    while (i != NIL || !stack.empty()) {
+      for (; i != NIL; i = nodes_[i].left) {
+        stack.push_back(i);
+      }
+      const Node& node = nodes_[stack.back()];
+      stack.pop_back();
+      callback(node.value);
+      i = node.right;
+    }
   }
-};
 
+  // Replaces the contents with a perfectly balanced tree holding the
+  // values in [first, last), which is sorted first.
+  template<typename Iterator>
+  void build(Iterator first, Iterator last, int threads = 1) {
+    std::vector<T> values(first, last);
+    std::sort(values.begin(), values.end());
+    build_sorted(values.begin(), values.end(), threads);
+  }
+
+  // Same as build() for an already sorted random access range. Nodes are
+  // laid out in preorder, and each subtree occupies a known index range,
+  // so the top levels can be handed out to separate threads.
+  template<typename Iterator>
+  void build_sorted(Iterator first, Iterator last, int threads = 1) {
+    clear();
+    index n = last - first;
+    if (n == 0) return;
+    nodes_.resize(n, Node(*first));
+    build_(first, 0, n, 0, threads);
+    root = 0;
+  }
+
+  // Union of both trees, in time linear in their sizes.
+  void merge(const BinaryTree& other) {
+    std::vector<T> a, b, values;
+    flatten(a);
+    other.flatten(b);
+    values.reserve(a.size() + b.size());
+    std::merge(a.begin(), a.end(), b.begin(), b.end(),
+               std::back_inserter(values));
+    build_sorted(values.begin(), values.end());
+  }
+
+  // Renumbers the nodes so that storage order matches the given visiting
+  // order: PREORDER makes traverse() a sequential scan, BFS packs the top
+  // levels used by every search into the first few cache lines.
+  void relayout(Layout layout = PREORDER) {
+    std::vector<index> order;
+    order.reserve(size());
+    if (root != NIL) {
+      order.push_back(root);
+    }
+    if (layout == BFS) {
+      for (unsigned i = 0; i < order.size(); i++) {
+        const Node& node = nodes_[order[i]];
+        if (node.left != NIL) order.push_back(node.left);
+        if (node.right != NIL) order.push_back(node.right);
+      }
+    } else {
+      std::vector<index> stack(order);
+      order.clear();
+      while (!stack.empty()) {
+        index i = stack.back();
+        stack.pop_back();
+        order.push_back(i);
+        if (nodes_[i].right != NIL) stack.push_back(nodes_[i].right);
+        if (nodes_[i].left != NIL) stack.push_back(nodes_[i].left);
+      }
+    }
+    std::vector<index> renumber(nodes_.slots(), NIL);
+    for (unsigned i = 0; i < order.size(); i++) {
+      renumber[order[i]] = i;
+    }
+    NodeArena<Node> fresh;
+    for (unsigned i = 0; i < order.size(); i++) {
+      Node node(nodes_[order[i]]);
+      if (node.left != NIL) node.left = renumber[node.left];
+      if (node.right != NIL) node.right = renumber[node.right];
+      fresh.allocate(node);
+    }
+    nodes_.swap(fresh);
+    root = order.empty() ? NIL : 0;
+  }
+
+ private:
+  friend Balance;
+
+  int size_of(index i) const {
+    return i == NIL ? 0 : nodes_[i].size;
+  }
+
+  void refresh(index i) {
+    Node& node = nodes_[i];
+    node.size = 1 + size_of(node.left) + size_of(node.right);
+    Balance::refresh(*this, i);
+  }
+
+  index rotate_left(index i) {
+    index r = nodes_[i].right;
+    nodes_[i].right = nodes_[r].left;
+    nodes_[r].left = i;
+    refresh(i);
+    refresh(r);
+    return r;
+  }
+
+  index rotate_right(index i) {
+    index l = nodes_[i].left;
+    nodes_[i].left = nodes_[l].right;
+    nodes_[l].right = i;
+    refresh(i);
+    refresh(l);
+    return l;
+  }
+
+  // Builds the subtree for [lo, hi) at index base, returns its height.
+  template<typename Iterator>
+  int build_(Iterator first, index lo, index hi, index base, int threads) {
+    if (lo == hi) return 0;
+    index mid = lo + (hi - lo) / 2;
+    Node& node = nodes_[base];
+    node.value = first[mid];
+    node.size = hi - lo;
+    node.left = lo < mid ? base + 1 : NIL;
+    node.right = mid + 1 < hi ? base + 1 + (mid - lo) : NIL;
+    int left, right;
+    if (threads > 1 && hi - lo >= PARALLEL_SIZE) {
+      std::thread worker([&] {
+        left = build_(first, lo, mid, base + 1, threads / 2);
+      });
+      right = build_(first, mid + 1, hi, base + 1 + (mid - lo),
+                     threads - threads / 2);
+      worker.join();
+    } else {
+      left = build_(first, lo, mid, base + 1, 1);
+      right = build_(first, mid + 1, hi, base + 1 + (mid - lo), 1);
+    }
+    int height = 1 + std::max(left, right);
+    Balance::template built<BinaryTree>(node, base, height);
+    return height;
+  }
+
+  void flatten(std::vector<T>& out) const {
+    out.reserve(size());
+    inorder([&out](const T& value) {
+      out.push_back(value);
+    });
+  }
+
+  // The link that points to path_[d], either root or a child field.
+  index& link(int d) {
+    if (d == 0) return root;
+    Node& parent = nodes_[path_[d - 1]];
+    return parent.left == path_[d] ? parent.left : parent.right;
+  }
+
+  // Refreshes and fixes every node of path_[0..d], bottom-up.
+  void rebalance(int d) {
+    for (; d >= 0; d--) {
+      index i = path_[d];
+      refresh(i);
+      index fixed = Balance::fix(*this, i);
+      if (fixed != i) {
+        link(d) = fixed;
+      }
+    }
+  }
+
+  // xorshift32, used by Treap for priorities.
+  unsigned random() {
+    seed_ ^= seed_ << 13;
+    seed_ ^= seed_ >> 17;
+    seed_ ^= seed_ << 5;
+    return seed_;
+  }
+
+  static const index PARALLEL_SIZE = 1 << 16;
+
+  NodeArena<Node> nodes_;
+  std::vector<index> path_;
+  unsigned seed_;
+};
 
+template<class T, class Balance>
+const typename BinaryTree<T, Balance>::index BinaryTree<T, Balance>::NIL;
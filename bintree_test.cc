@@ -1,3 +1,5 @@
+#include <iterator>
+#include <set>
 #include <vector>
 #include <algorithm>
 #include "gtest/gtest.h"
@@ -24,3 +26,187 @@ TEST(BinarytreeTest, InsertAndTraverse) {
 }
 
 
+
+struct Collect {
+  vector<int>* values;
+  void operator()(const int& value) {
+    values->push_back(value);
+  }
+};
+
+TEST(BinarytreeTest, Preorder) {
+  BinaryTree<int> tree;
+  int values[] = {3, 6, 2, 0, 8, 1, 9, 7, 4, 5};
+  int preorder[] = {3, 2, 0, 1, 6, 4, 5, 8, 7, 9};
+  for (int i = 0; i < 10; i++)
+    tree.insert(values[i]);
+  vector<int> out;
+  Collect collect = {&out};
+  tree.traverse(collect);
+  EXPECT_EQ(vector<int>(preorder, preorder + 10), out);
+  EXPECT_EQ(10, tree.size());
+}
+
+TEST(BinarytreeTest, Relayout) {
+  BinaryTree<int> tree;
+  for (int i = 0; i < 10000; i++)
+    tree.insert((i * 7919) % 10007);
+  vector<int> before, after;
+  Collect collect = {&before};
+  tree.traverse(collect);
+
+  tree.relayout();
+  collect.values = &after;
+  tree.traverse(collect);
+  EXPECT_EQ(before, after);
+  // In preorder layout each node's left child is the next node.
+  for (int i = 0; i < tree.size(); i++) {
+    unsigned left = tree.node(i).left;
+    if (left != BinaryTree<int>::NIL) {
+      EXPECT_EQ(unsigned(i + 1), left);
+    }
+  }
+
+  tree.relayout(BinaryTree<int>::BFS);
+  after.clear();
+  tree.traverse(collect);
+  EXPECT_EQ(before, after);
+  EXPECT_EQ(0U, tree.root);
+}
+
+TEST(BinarytreeTest, Clear) {
+  BinaryTree<int> tree;
+  for (int i = 0; i < 5000; i++)
+    tree.insert(i % 100);
+  tree.clear();
+  EXPECT_EQ(0, tree.size());
+  tree.insert(1);
+  EXPECT_EQ(1, tree.size());
+  EXPECT_EQ(0U, tree.root);
+}
+
+template<class Tree>
+void check_order_statistics(Tree& tree, const multiset<int>& reference) {
+  ASSERT_EQ(int(reference.size()), tree.size());
+  vector<int> sorted;
+  Collect collect = {&sorted};
+  tree.inorder(collect);
+  EXPECT_TRUE(equal(reference.begin(), reference.end(), sorted.begin()));
+  for (int k = 0; k < tree.size(); k += 97) {
+    EXPECT_EQ(sorted[k], tree.kth(k));
+  }
+  for (int v = -5; v < 1005; v += 13) {
+    EXPECT_EQ(int(distance(reference.begin(), reference.lower_bound(v))),
+              tree.rank(v));
+    EXPECT_EQ(reference.count(v) > 0, tree.find(v) != Tree::NIL);
+  }
+}
+
+template<class Balance>
+void check_balanced() {
+  BinaryTree<int, Balance> tree;
+  multiset<int> reference;
+  for (int i = 0; i < 100000; i++) {
+    tree.insert(i);
+  }
+  EXPECT_LE(tree.depth(), 40);
+  tree.clear();
+  for (int i = 0; i < 3000; i++) {
+    int v = (i * 7919) % 1000;
+    tree.insert(v);
+    reference.insert(v);
+  }
+  check_order_statistics(tree, reference);
+  for (int i = 0; i < 2000; i++) {
+    int v = (i * 104729) % 1100;
+    bool present = reference.count(v) > 0;
+    EXPECT_EQ(present, tree.erase(v));
+    if (present) {
+      reference.erase(reference.find(v));
+    }
+  }
+  check_order_statistics(tree, reference);
+  EXPECT_LE(tree.depth(), 40);
+}
+
+TEST(BinarytreeTest, AVL) {
+  check_balanced<AVL>();
+}
+
+TEST(BinarytreeTest, Treap) {
+  check_balanced<Treap>();
+}
+
+TEST(BinarytreeTest, UnbalancedOrderStatistics) {
+  BinaryTree<int> tree;
+  multiset<int> reference;
+  for (int i = 0; i < 3000; i++) {
+    int v = (i * 7919) % 1000;
+    tree.insert(v);
+    reference.insert(v);
+  }
+  for (int i = 0; i < 500; i++) {
+    tree.erase(i * 2);
+    reference.erase(reference.find(i * 2));
+  }
+  check_order_statistics(tree, reference);
+}
+
+TEST(BinarytreeTest, DegenerateTraverse) {
+  BinaryTree<int> tree;
+  for (int i = 0; i < 5000; i++)
+    tree.insert(-i);
+  vector<int> out;
+  Collect collect = {&out};
+  tree.traverse(collect);
+  EXPECT_EQ(5000U, out.size());
+  EXPECT_EQ(-4999, out.back());
+}
+
+template<class Balance>
+void check_build(int threads, int max_depth) {
+  vector<int> values;
+  for (int i = 0; i < 200000; i++) {
+    values.push_back((i * 7919LL) % 100003);
+  }
+  BinaryTree<int, Balance> tree;
+  tree.build(values.begin(), values.end(), threads);
+  EXPECT_EQ(200000, tree.size());
+  EXPECT_EQ(18, tree.depth());
+  multiset<int> reference(values.begin(), values.end());
+  check_order_statistics(tree, reference);
+  for (int i = 0; i < 1000; i++) {
+    tree.insert(i);
+    reference.insert(i);
+    tree.erase(i * 3);
+    reference.erase(reference.find(i * 3));
+  }
+  check_order_statistics(tree, reference);
+  EXPECT_LE(tree.depth(), max_depth);
+}
+
+TEST(BinarytreeTest, Build) {
+  check_build<Unbalanced>(1, 200000);
+  check_build<AVL>(1, 25);
+  check_build<Treap>(1, 32);
+}
+
+TEST(BinarytreeTest, ParallelBuild) {
+  check_build<Unbalanced>(4, 200000);
+  check_build<AVL>(3, 25);
+  check_build<Treap>(4, 32);
+}
+
+TEST(BinarytreeTest, Merge) {
+  BinaryTree<int, AVL> a, b;
+  multiset<int> reference;
+  for (int i = 0; i < 1000; i++) {
+    a.insert(i * 2);
+    b.insert(i * 3);
+    reference.insert(i * 2);
+    reference.insert(i * 3);
+  }
+  a.merge(b);
+  check_order_statistics(a, reference);
+  EXPECT_EQ(11, a.depth());
+}
@@ -1,16 +1,40 @@
 #include <vector>
 #include <numeric>
+#include <thread>
+#include <algorithm>
+
+//reserve ChineseRemainder Garner eval digits
+
+// Type wide enough to hold the product of two values of type T.
+template<typename T> struct WideMul { typedef T type; };
+template<> struct WideMul<int> { typedef long long type; };
+template<> struct WideMul<unsigned> { typedef unsigned long long type; };
+template<> struct WideMul<long long> { typedef __int128 type; };
+template<> struct WideMul<unsigned long long> {
+  typedef unsigned __int128 type;
+};
+
+template<typename T>
+T mulmod(const T& a, const T& b, const T& m) {
+  typedef typename WideMul<T>::type W;
+  return T(W(a) * W(b) % W(m));
+}
 
 template<typename T>
 class ChineseRemainder {
  public:
-  ChineseRemainder(const std::vector<T>& modules) : ei_(modules.size()) {
-    T p = std::accumulate(modules.begin(), modules.end(),
-                          T(1), std::multiplies<T>());
+  ChineseRemainder(const std::vector<T>& modules)
+      : ei_(modules.size()), reduced_(modules.size()) {
+    p_ = std::accumulate(modules.begin(), modules.end(),
+                         T(1), std::multiplies<T>());
     for (unsigned i = 0; i < modules.size(); i++) {
-      T si = p / modules[i];
+      T si = p_ / modules[i];
       pii r = egcd(modules[i], si);
       ei_[i] = r.second * si;
+      reduced_[i] = ei_[i] % p_;
+      if (reduced_[i] < T(0)) {
+        reduced_[i] = reduced_[i] + p_;
+      }
     }
   }
 
@@ -18,6 +42,43 @@ class ChineseRemainder {
     return std::inner_product(ai.begin(), ai.end(), ei_.begin(), T(0));
   }
 
+  // Structure-of-arrays batch: columns[i][k] is the residue of tuple k
+  // modulo modules[i] (any value, negative included), and out[k] receives
+  // its solution in [0, p). Each thread owns a contiguous slice of the
+  // tuples and walks it in tiles, one column at a time, so a tile of out
+  // stays in cache while the columns stream past. The products still go
+  // through mulmod's wide division, which does not vectorize.
+  void eval(const T* const* columns, int n, T* out, int threads = 1) const {
+    if (threads <= 1 || n < threads * TILE) {
+      eval_slice(columns, 0, n, out);
+      return;
+    }
+    std::vector<std::thread> workers;
+    int slice = (n + threads - 1) / threads;
+    for (int begin = 0; begin < n; begin += slice) {
+      int end = std::min(n, begin + slice);
+      workers.push_back(std::thread([=] {
+        eval_slice(columns, begin, end, out);
+      }));
+    }
+    for (unsigned i = 0; i < workers.size(); i++) {
+      workers[i].join();
+    }
+  }
+
+  void eval(const std::vector<std::vector<T> >& columns, std::vector<T>& out,
+            int threads = 1) const {
+    out.resize(columns.empty() ? 0 : columns[0].size());
+    if (out.empty()) {
+      return;
+    }
+    std::vector<const T*> ptr(columns.size());
+    for (unsigned i = 0; i < columns.size(); i++) {
+      ptr[i] = columns[i].data();
+    }
+    eval(ptr.data(), out.size(), out.data(), threads);
+  }
+
  private:
   typedef std::pair<T, T> pii;
 
@@ -32,6 +93,130 @@ class ChineseRemainder {
     }
   }
 
-  std::vector<T> ei_;
+  void eval_slice(const T* const* columns, int begin, int end, T* out) const {
+    for (int tile = begin; tile < end; tile += TILE) {
+      int last = std::min(end, tile + TILE);
+      std::fill(out + tile, out + last, T(0));
+      for (unsigned i = 0; i < reduced_.size(); i++) {
+        const T* col = columns[i];
+        const T e = reduced_[i];
+        for (int k = tile; k < last; k++) {
+          T t = mulmod(col[k], e, p_);
+          T gap = t < T(0) ? -t : p_ - t;
+          out[k] = out[k] >= gap ? out[k] - gap : out[k] + (p_ - gap);
+        }
+      }
+    }
+  }
+
+  static const int TILE = 1024;
+
+  std::vector<T> ei_, reduced_;
+  T p_;
 };
 
+// Garner's mixed-radix reconstruction. The solution is written as
+// x = v0 + v1*m0 + v2*m0*m1 + ..., and every digit vi is computed modulo
+// mi alone, so T only has to hold a single modulus (products go through
+// WideMul<T>). T must be signed and the moduli pairwise coprime.
+template<typename T>
+class Garner {
+ public:
+  Garner(const std::vector<T>& modules)
+      : modules_(modules), inv_(modules.size()) {
+    for (unsigned i = 0; i < modules_.size(); i++) {
+      inv_[i].resize(i);
+      for (unsigned j = 0; j < i; j++) {
+        inv_[i][j] = inverse(modules_[j] % modules_[i], modules_[i]);
+      }
+    }
+  }
+
+  // Mixed-radix digits of the solution, vi[i] < modules[i].
+  void digits(const T* ai, T* vi) const {
+    for (unsigned i = 0; i < modules_.size(); i++) {
+      const T& m = modules_[i];
+      T v = normalize(ai[i], m);
+      for (unsigned j = 0; j < i; j++) {
+        v = mulmod(normalize(v - vi[j] % m, m), inv_[i][j], m);
+      }
+      vi[i] = v;
+    }
+  }
+
+  // Solution modulo target.
+  T eval(const std::vector<T>& ai, const T& target) const {
+    std::vector<T> vi(modules_.size());
+    digits(ai.data(), vi.data());
+    T ans = T(0), radix = T(1) % target;
+    for (unsigned i = 0; i < modules_.size(); i++) {
+      ans = addmod(ans, mulmod(vi[i] % target, radix, target), target);
+      radix = mulmod(radix, modules_[i] % target, target);
+    }
+    return ans;
+  }
+
+  // Exact solution in a wider type R (e.g. bigint), built only at the end.
+  template<typename R>
+  R eval(const std::vector<T>& ai) const {
+    int n = modules_.size();
+    if (n == 0) {
+      return R(0);
+    }
+    std::vector<T> vi(n);
+    digits(ai.data(), vi.data());
+    R ans(vi[n - 1]);
+    for (int i = n - 2; i >= 0; i--) {
+      ans = ans * R(modules_[i]) + R(vi[i]);
+    }
+    return ans;
+  }
+
+  // Solutions modulo target for many residue vectors sharing the moduli.
+  void eval(const std::vector<std::vector<T> >& batch, const T& target,
+            std::vector<T>& out) const {
+    std::vector<T> radix(modules_.size());
+    T r = T(1) % target;
+    for (unsigned i = 0; i < modules_.size(); i++) {
+      radix[i] = r;
+      r = mulmod(r, modules_[i] % target, target);
+    }
+    out.resize(batch.size());
+    std::vector<T> vi(modules_.size());
+    for (unsigned k = 0; k < batch.size(); k++) {
+      digits(batch[k].data(), vi.data());
+      T ans = T(0);
+      for (unsigned i = 0; i < modules_.size(); i++) {
+        ans = addmod(ans, mulmod(vi[i] % target, radix[i], target), target);
+      }
+      out[k] = ans;
+    }
+  }
+
+ private:
+  // a + b modulo m for a, b in [0, m), without overflowing T.
+  static T addmod(const T& a, const T& b, const T& m) {
+    return a >= m - b ? a - (m - b) : a + b;
+  }
+
+  static T normalize(const T& a, const T& m) {
+    T r = a % m;
+    return r < T(0) ? r + m : r;
+  }
+
+  static T inverse(const T& a, const T& m) {
+    T r0 = a, r1 = m, s0 = T(1), s1 = T(0);
+    while (r1 != T(0)) {
+      T q = r0 / r1, t = r1;
+      r1 = r0 - q * r1;
+      r0 = t;
+      t = s1;
+      s1 = s0 - q * s1;
+      s0 = t;
+    }
+    return normalize(s0, m);
+  }
+
+  std::vector<T> modules_;
+  std::vector<std::vector<T> > inv_;
+};
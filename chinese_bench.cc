@@ -0,0 +1,62 @@
+#include <vector>
+#include "bench.h"
+#include "bigint.h"
+#include "chinese.h"
+
+std::vector<long long> moduli(int k) {
+  long long primes[6] = {998244353, 1000000007, 1000000009, 1000000021,
+                         1000000033, 1000000087};
+  return std::vector<long long>(primes, primes + k);
+}
+
+std::vector<std::vector<long long> > residues(
+    const std::vector<long long>& mods, int n) {
+  std::vector<std::vector<long long> > columns(mods.size());
+  unsigned seed = 12345;
+  for (unsigned i = 0; i < mods.size(); i++) {
+    columns[i].resize(n);
+    for (int k = 0; k < n; k++) {
+      seed = seed * 1103515245 + 12345;
+      columns[i][k] = seed % mods[i];
+    }
+  }
+  return columns;
+}
+
+// Two 30-bit moduli: the product still fits in a long long.
+BENCH(ChineseRemainderBatch, 1 << 10, 1 << 16) {
+  std::vector<long long> mods = moduli(2);
+  ChineseRemainder<long long> crt(mods);
+  std::vector<std::vector<long long> > columns = residues(mods, state.arg());
+  std::vector<long long> out;
+  while (state.run()) {
+    crt.eval(columns, out);
+    do_not_optimize(out);
+  }
+}
+
+BENCH(GarnerModTarget, 2, 6) {
+  std::vector<long long> mods = moduli(state.arg());
+  Garner<long long> garner(mods);
+  std::vector<std::vector<long long> > columns = residues(mods, 1);
+  std::vector<long long> ai(mods.size());
+  for (unsigned i = 0; i < mods.size(); i++) {
+    ai[i] = columns[i][0];
+  }
+  while (state.run()) {
+    do_not_optimize(garner.eval(ai, 1000000007LL));
+  }
+}
+
+BENCH(GarnerBigint, 2, 6) {
+  std::vector<long long> mods = moduli(state.arg());
+  Garner<long long> garner(mods);
+  std::vector<std::vector<long long> > columns = residues(mods, 1);
+  std::vector<long long> ai(mods.size());
+  for (unsigned i = 0; i < mods.size(); i++) {
+    ai[i] = columns[i][0] % 1000;
+  }
+  while (state.run()) {
+    do_not_optimize(garner.eval<bigint>(ai));
+  }
+}
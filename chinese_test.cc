@@ -1,4 +1,5 @@
 #include "gtest/gtest.h"
+#include "bigint.h"
 #include "chinese.h"
 
 TEST(ChineseRemainderTest, Eval) {
@@ -12,3 +13,165 @@ TEST(ChineseRemainderTest, Eval) {
   EXPECT_EQ(4, ans % 13);
 }
 
+
+TEST(GarnerTest, EvalModTarget) {
+  int mods[4] = {3, 5, 7, 13};
+  int rems[4] = {1, 2, 3, 4};
+  Garner<int> garner(std::vector<int>(mods, mods + 4));
+  int ans = garner.eval(std::vector<int>(rems, rems + 4), 3 * 5 * 7 * 13);
+  EXPECT_EQ(1, ans % 3);
+  EXPECT_EQ(2, ans % 5);
+  EXPECT_EQ(3, ans % 7);
+  EXPECT_EQ(4, ans % 13);
+  EXPECT_EQ(ans % 11, garner.eval(std::vector<int>(rems, rems + 4), 11));
+}
+
+TEST(GarnerTest, NegativeResidues) {
+  int mods[3] = {3, 5, 7};
+  int rems[3] = {-1, -2, -3};
+  Garner<int> garner(std::vector<int>(mods, mods + 3));
+  EXPECT_EQ(53, garner.eval(std::vector<int>(rems, rems + 3), 105));
+}
+
+long long mod_decimal(const char* s, long long m) {
+  long long ans = 0;
+  for (; *s; s++) {
+    ans = (ans * 10 + *s - '0') % m;
+  }
+  return ans;
+}
+
+TEST(GarnerTest, Bigint) {
+  const char x[] = "123456789012345678901234567";
+  long long mods[3] = {1000000007LL, 998244353LL, 1000000009LL};
+  std::vector<long long> rems;
+  for (int i = 0; i < 3; i++) {
+    rems.push_back(mod_decimal(x, mods[i]));
+  }
+  Garner<long long> garner(std::vector<long long>(mods, mods + 3));
+  EXPECT_EQ(bigint(x), garner.eval<bigint>(rems));
+  EXPECT_EQ(mod_decimal(x, 1000000000000000003LL),
+            garner.eval(rems, 1000000000000000003LL));
+}
+
+TEST(GarnerTest, WideModuli) {
+  // Moduli and mixed-radix digits above 2^32 must reach bigint whole.
+  long long mods[2] = {4294967311LL, 4294967357LL};
+  long long x = 123456789012345LL;
+  std::vector<long long> rems;
+  for (int i = 0; i < 2; i++) {
+    rems.push_back(x % mods[i]);
+  }
+  Garner<long long> garner(std::vector<long long>(mods, mods + 2));
+  EXPECT_EQ(bigint("123456789012345"), garner.eval<bigint>(rems));
+  EXPECT_EQ(x, garner.eval(rems, 1000000000000000000LL));
+}
+
+TEST(GarnerTest, Batch) {
+  long long mods[3] = {1000000007LL, 998244353LL, 1000000009LL};
+  Garner<long long> garner(std::vector<long long>(mods, mods + 3));
+  const char* xs[3] = {"0", "42", "999999999999999999999999"};
+  std::vector<std::vector<long long> > batch(3);
+  for (int k = 0; k < 3; k++) {
+    for (int i = 0; i < 3; i++) {
+      batch[k].push_back(mod_decimal(xs[k], mods[i]));
+    }
+  }
+  std::vector<long long> out;
+  garner.eval(batch, 1000000000000000000LL, out);
+  ASSERT_EQ(3U, out.size());
+  EXPECT_EQ(0LL, out[0]);
+  EXPECT_EQ(42LL, out[1]);
+  EXPECT_EQ(999999999999999999LL, out[2]);
+}
+
+TEST(GarnerTest, LargeTarget) {
+  // Partial sums exceed LLONG_MAX / 2, so a plain add would overflow.
+  const char x[] = "8999999999999999999";
+  long long mods[3] = {1000000007LL, 998244353LL, 1000000009LL};
+  std::vector<long long> rems;
+  for (int i = 0; i < 3; i++) {
+    rems.push_back(mod_decimal(x, mods[i]));
+  }
+  Garner<long long> garner(std::vector<long long>(mods, mods + 3));
+  EXPECT_EQ(8999999999999999999LL, garner.eval(rems, 9000000000000000000LL));
+}
+
+TEST(GarnerTest, Empty) {
+  Garner<int> garner((std::vector<int>()));
+  EXPECT_EQ(bigint(0), garner.eval<bigint>(std::vector<int>()));
+  EXPECT_EQ(0, garner.eval(std::vector<int>(), 7));
+}
+
+TEST(GarnerTest, SharedBetweenThreads) {
+  long long mods[3] = {1000000007LL, 998244353LL, 1000000009LL};
+  Garner<long long> garner(std::vector<long long>(mods, mods + 3));
+  std::vector<std::thread> threads;
+  std::vector<int> wrong(4);
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([&garner, &mods, &wrong, t] {
+      for (long long x = t; x < 20000; x += 4) {
+        std::vector<long long> rems;
+        for (int i = 0; i < 3; i++) {
+          rems.push_back(x * x % mods[i]);
+        }
+        wrong[t] += garner.eval(rems, 1000000000000000000LL) != x * x;
+      }
+    }));
+  }
+  for (int t = 0; t < 4; t++) {
+    threads[t].join();
+  }
+  EXPECT_EQ(std::vector<int>(4), wrong);
+}
+
+TEST(ChineseRemainderTest, BatchColumns) {
+  long long mods[3] = {1000003LL, 999983LL, 1000033LL};
+  ChineseRemainder<long long> crt(std::vector<long long>(mods, mods + 3));
+  int n = 5000;
+  std::vector<std::vector<long long> > columns(3, std::vector<long long>(n));
+  std::vector<long long> expected(n);
+  for (int k = 0; k < n; k++) {
+    expected[k] = 1234567LL * k * k + 89LL * k;
+    for (int i = 0; i < 3; i++) {
+      columns[i][k] = expected[k] % mods[i];
+    }
+  }
+  std::vector<long long> single, threaded;
+  crt.eval(columns, single);
+  crt.eval(columns, threaded, 4);
+  ASSERT_EQ(static_cast<unsigned>(n), single.size());
+  for (int k = 0; k < n; k++) {
+    EXPECT_EQ(expected[k], single[k]);
+    EXPECT_EQ(expected[k], threaded[k]);
+  }
+}
+
+TEST(ChineseRemainderTest, BatchUnreducedResidues) {
+  long long mods[3] = {1000003LL, 999983LL, 1000033LL};
+  ChineseRemainder<long long> crt(std::vector<long long>(mods, mods + 3));
+  std::vector<std::vector<long long> > columns(3);
+  long long xs[4] = {0, 1, 123456789012345LL, 999999999999LL};
+  for (int k = 0; k < 4; k++) {
+    for (int i = 0; i < 3; i++) {
+      // Shift by multiples of the modulus, both ways.
+      columns[i].push_back(xs[k] % mods[i] + (k - 2) * 5 * mods[i]);
+    }
+  }
+  std::vector<long long> out;
+  crt.eval(columns, out);
+  ASSERT_EQ(4U, out.size());
+  for (int k = 0; k < 4; k++) {
+    EXPECT_EQ(xs[k], out[k]);
+  }
+}
+
+TEST(ChineseRemainderTest, BatchEmpty) {
+  long long mods[2] = {3, 5};
+  ChineseRemainder<long long> crt(std::vector<long long>(mods, mods + 2));
+  std::vector<long long> out(3);
+  crt.eval(std::vector<std::vector<long long> >(), out);
+  EXPECT_TRUE(out.empty());
+  crt.eval(std::vector<std::vector<long long> >(2), out, 4);
+  EXPECT_TRUE(out.empty());
+}
@@ -0,0 +1,97 @@
+#include <cstdint>
+#include <vector>
+#include "bintree.h"
+
+//reserve Eytzinger lower_bound count traverse
+
+// Read-only search structure in Eytzinger (BFS) order: node k has its
+// children at 2k and 2k + 1, so a search is a branchless walk over one
+// array. The BLOCK = 64 / sizeof(T) descendants log2(BLOCK) levels down
+// (four for 4-byte keys) share a cache line, which is prefetched while the
+// current level is compared.
+template<class T>
+class Eytzinger {
+ public:
+  // [first, last) must be sorted.
+  template<typename Iterator>
+  Eytzinger(Iterator first, Iterator last) {
+    std::vector<T> sorted(first, last);
+    build(sorted);
+  }
+
+  template<class Balance>
+  explicit Eytzinger(const BinaryTree<T, Balance>& tree) {
+    std::vector<T> sorted;
+    sorted.reserve(tree.size());
+    tree.inorder([&sorted](const T& value) {
+      sorted.push_back(value);
+    });
+    build(sorted);
+  }
+
+  Eytzinger(const Eytzinger&) = delete;
+  Eytzinger& operator=(const Eytzinger&) = delete;
+
+  int size() const {
+    return n_;
+  }
+
+  // Position in sorted order of the first element >= x, size() if none.
+  int lower_bound(const T& x) const {
+    unsigned k = 1;
+    while (k <= n_) {
+      __builtin_prefetch(a_ + k * BLOCK);
+      k = 2 * k + (a_[k] < x);
+    }
+    k >>= __builtin_ffs(~k);
+    return k == 0 ? n_ : rank_[k];
+  }
+
+  // Number of elements in [lo, hi).
+  int count(const T& lo, const T& hi) const {
+    return std::max(0, lower_bound(hi) - lower_bound(lo));
+  }
+
+  // Visits the values in sorted order.
+  template<typename Q>
+  void traverse(Q callback) const {
+    if (n_ == 0) return;
+    unsigned k = 1;
+    while (2 * k <= n_) k *= 2;
+    for (unsigned i = 0; i < n_; i++) {
+      callback(a_[k]);
+      if (2 * k + 1 <= n_) {
+        k = 2 * k + 1;
+        while (2 * k <= n_) k *= 2;
+      } else {
+        k >>= __builtin_ffs(~k);
+      }
+    }
+  }
+
+ private:
+  static const unsigned BLOCK = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+  void build(const std::vector<T>& sorted) {
+    n_ = sorted.size();
+    storage_.resize(n_ + 1 + BLOCK);
+    rank_.resize(n_ + 1);
+    uintptr_t address = reinterpret_cast<uintptr_t>(&storage_[0]);
+    a_ = &storage_[0] + (64 - address % 64) % 64 / sizeof(T) % BLOCK;
+    unsigned i = 0;
+    fill(sorted, 1, i);
+  }
+
+  void fill(const std::vector<T>& sorted, unsigned k, unsigned& i) {
+    if (k > n_) return;
+    fill(sorted, 2 * k, i);
+    a_[k] = sorted[i];
+    rank_[k] = i++;
+    fill(sorted, 2 * k + 1, i);
+  }
+
+  std::vector<T> storage_;
+  std::vector<int> rank_;
+  T* a_;
+  unsigned n_;
+};
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <vector>
+#include "bench.h"
+#include "eytzinger.h"
+
+std::vector<int> random_values(int n) {
+  std::vector<int> values(n);
+  unsigned seed = 12345;
+  for (int i = 0; i < n; i++) {
+    seed = seed * 1103515245 + 12345;
+    values[i] = seed >> 1;
+  }
+  return values;
+}
+
+BENCH(PointerTreeRank, 1 << 10, 1 << 16, 1 << 22) {
+  std::vector<int> values = random_values(state.arg());
+  BinaryTree<int> tree;
+  for (unsigned i = 0; i < values.size(); i++) {
+    tree.insert(values[i]);
+  }
+  int i = 0;
+  while (state.run()) {
+    do_not_optimize(tree.rank(values[i++ & (state.arg() - 1)] ^ 1));
+  }
+}
+
+BENCH(StdLowerBound, 1 << 10, 1 << 16, 1 << 22) {
+  std::vector<int> values = random_values(state.arg());
+  std::vector<int> sorted(values);
+  std::sort(sorted.begin(), sorted.end());
+  int i = 0;
+  while (state.run()) {
+    int x = values[i++ & (state.arg() - 1)] ^ 1;
+    do_not_optimize(std::lower_bound(sorted.begin(), sorted.end(), x));
+  }
+}
+
+BENCH(EytzingerLowerBound, 1 << 10, 1 << 16, 1 << 22) {
+  std::vector<int> values = random_values(state.arg());
+  std::vector<int> sorted(values);
+  std::sort(sorted.begin(), sorted.end());
+  Eytzinger<int> tree(sorted.begin(), sorted.end());
+  int i = 0;
+  while (state.run()) {
+    do_not_optimize(tree.lower_bound(values[i++ & (state.arg() - 1)] ^ 1));
+  }
+}
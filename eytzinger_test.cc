@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <vector>
+#include "gtest/gtest.h"
+#include "eytzinger.h"
+
+using namespace std;
+
+TEST(EytzingerTest, LowerBound) {
+  for (int n = 0; n < 70; n++) {
+    vector<int> sorted;
+    for (int i = 0; i < n; i++) {
+      sorted.push_back(i * 2 + (i % 3 == 0));
+    }
+    Eytzinger<int> tree(sorted.begin(), sorted.end());
+    EXPECT_EQ(n, tree.size());
+    for (int x = -2; x < 2 * n + 3; x++) {
+      int expected = std::lower_bound(sorted.begin(), sorted.end(), x) -
+                     sorted.begin();
+      EXPECT_EQ(expected, tree.lower_bound(x));
+    }
+  }
+}
+
+TEST(EytzingerTest, Duplicates) {
+  int values[] = {1, 1, 2, 2, 2, 3, 5, 5};
+  Eytzinger<int> tree(values, values + 8);
+  EXPECT_EQ(0, tree.lower_bound(1));
+  EXPECT_EQ(2, tree.lower_bound(2));
+  EXPECT_EQ(5, tree.lower_bound(3));
+  EXPECT_EQ(6, tree.lower_bound(4));
+  EXPECT_EQ(8, tree.lower_bound(6));
+  EXPECT_EQ(3, tree.count(2, 3));
+  EXPECT_EQ(6, tree.count(2, 6));
+  EXPECT_EQ(0, tree.count(4, 5));
+  EXPECT_EQ(0, tree.count(5, 1));
+}
+
+TEST(EytzingerTest, FromBinaryTree) {
+  BinaryTree<int, AVL> source;
+  vector<int> sorted;
+  for (int i = 0; i < 1000; i++) {
+    source.insert((i * 7919) % 1009);
+    sorted.push_back((i * 7919) % 1009);
+  }
+  sort(sorted.begin(), sorted.end());
+  Eytzinger<int> tree(source);
+  vector<int> out;
+  tree.traverse([&out](int value) {
+    out.push_back(value);
+  });
+  EXPECT_EQ(sorted, out);
+  EXPECT_EQ(source.rank(500), tree.lower_bound(500));
+}
+
+TEST(EytzingerTest, LargeElements) {
+  vector<long long> sorted;
+  for (long long i = 0; i < 1000; i++) {
+    sorted.push_back(i * i);
+  }
+  Eytzinger<long long> tree(sorted.begin(), sorted.end());
+  EXPECT_EQ(32, tree.lower_bound(1000));
+  EXPECT_EQ(31, tree.lower_bound(961));
+  EXPECT_EQ(1000, tree.lower_bound(1000000));
+}
@@ -1,5 +1,7 @@
 #include <vector>
 
+//reserve fibonacci fast_fibonacci fibonacci_table nth pair range
+
 template<typename T>
 class fibonacci {
  public:
@@ -46,3 +48,135 @@ class fibonacci {
 };
 
 
+
+// Fast doubling: F(2k) = F(k)(2F(k+1) - F(k)), F(2k+1) = F(k)^2 + F(k+1)^2.
+// Three multiplications per bit of n and no precomputed table.
+template<typename T>
+class fast_fibonacci {
+ public:
+  template<typename Q>
+  T nth(Q n) const {
+    T a, b;
+    pair(n, a, b);
+    return a;
+  }
+
+  // a = F(n), b = F(n + 1).
+  template<typename Q>
+  void pair(Q n, T& a, T& b) const {
+    a = T(0);
+    b = T(1);
+    if (n == 0) return;
+    Q mask = 1;
+    while (mask <= n / 2) {
+      mask <<= 1;
+    }
+    for (; mask; mask >>= 1) {
+      T c = a * (b + b - a);
+      T d = a * a + b * b;
+      if (n & mask) {
+        a = d;
+        b = c + d;
+      } else {
+        a = c;
+        b = d;
+      }
+    }
+  }
+
+  // out[i] = F(sorted[i]). Each index is reached from the previous one,
+  // so the cost is logarithmic in the gaps instead of in the indices.
+  template<typename Q>
+  void nth(const std::vector<Q>& sorted, std::vector<T>& out) const {
+    out.resize(sorted.size());
+    T a(0), b(1);
+    Q current = 0;
+    for (unsigned i = 0; i < sorted.size(); i++) {
+      Q delta = sorted[i] - current;
+      if (delta < STEP) {
+        for (; delta; delta--) {
+          T c = a + b;
+          a = b;
+          b = c;
+        }
+      } else {
+        T x, y;
+        pair(delta, x, y);
+        // F(n+d) = F(n)F(d-1) + F(n+1)F(d), F(n+d+1) = F(n)F(d) + F(n+1)F(d+1).
+        T c = a * (y - x) + b * x;
+        b = a * x + b * y;
+        a = c;
+      }
+      current = sorted[i];
+      out[i] = a;
+    }
+  }
+
+  // F(n), F(n + 1), ..., F(n + k - 1): one jump plus k additions.
+  template<typename Q, typename OutputIterator>
+  void range(Q n, int k, OutputIterator out) const {
+    T a, b;
+    pair(n, a, b);
+    for (int i = 0; i < k; i++) {
+      *out++ = a;
+      T c = a + b;
+      a = b;
+      b = c;
+    }
+  }
+
+ private:
+  static const int STEP = 8;
+};
+
+// Compile-time table for literal types such as unsigned long long or
+// modint: F(0), ..., F(N - 1) for lookup, and F(2^i), F(2^i + 1) for every
+// bit, the constant part of fibonacci's base_. A constexpr instance lives
+// in the binary, and nth() only combines the terms for the bits of n.
+template<typename T, int N = 64>
+class fibonacci_table {
+ public:
+  constexpr fibonacci_table() : small_(), power_(), next_() {
+    small_[0] = T(0);
+    if (N > 1) {
+      small_[1] = T(1);
+    }
+    for (int i = 2; i < N; i++) {
+      small_[i] = small_[i - 1] + small_[i - 2];
+    }
+    power_[0] = T(1);
+    next_[0] = T(1);
+    for (int i = 1; i < BITS; i++) {
+      const T& a = power_[i - 1];
+      const T& b = next_[i - 1];
+      power_[i] = a * (b + b - a);
+      next_[i] = a * a + b * b;
+    }
+  }
+
+  constexpr const T& operator[](int n) const {
+    return small_[n];
+  }
+
+  template<typename Q>
+  constexpr T nth(Q n) const {
+    if (n < Q(N)) {
+      return small_[n];
+    }
+    T a(0), b(1);
+    for (int i = 0; n; i++, n >>= 1) {
+      if (n & 1) {
+        // F(m + k) = F(m)(F(k + 1) - F(k)) + F(m + 1)F(k).
+        T c = a * (next_[i] - power_[i]) + b * power_[i];
+        b = a * power_[i] + b * next_[i];
+        a = c;
+      }
+    }
+    return a;
+  }
+
+ private:
+  static const int BITS = 64;
+
+  T small_[N], power_[BITS], next_[BITS];
+};
@@ -0,0 +1,65 @@
+#include "bench.h"
+#include "bigint.h"
+#include "modint.h"
+#include "fibonacci.h"
+
+typedef modint<1000000007> mint;
+
+// The matrix class builds T(n) for small n, so modint needs unsigned indices.
+BENCH(MatrixModint, 1LL << 10, 1LL << 20, 1LL << 31) {
+  fibonacci<mint> fib(unsigned(state.arg()));
+  unsigned n = state.arg() - 1;
+  while (state.run()) {
+    do_not_optimize(fib.nth(n));
+  }
+}
+
+BENCH(DoublingModint, 1LL << 10, 1LL << 20, 1LL << 31) {
+  fast_fibonacci<mint> fib;
+  unsigned n = state.arg() - 1;
+  while (state.run()) {
+    do_not_optimize(fib.nth(n));
+  }
+}
+
+BENCH(MatrixBigint, 1000, 10000) {
+  fibonacci<bigint> fib(state.arg());
+  while (state.run()) {
+    do_not_optimize(fib.nth(state.arg() - 1));
+  }
+}
+
+BENCH(DoublingBigint, 1000, 10000) {
+  fast_fibonacci<bigint> fib;
+  while (state.run()) {
+    do_not_optimize(fib.nth(state.arg() - 1));
+  }
+}
+
+BENCH(MatrixRangeModint, 1000) {
+  fibonacci<mint> fib(1U << 31);
+  std::vector<mint> out(state.arg());
+  while (state.run()) {
+    for (unsigned i = 0; i < state.arg(); i++) {
+      out[i] = fib.nth((1U << 30) + i);
+    }
+    do_not_optimize(out);
+  }
+}
+
+BENCH(DoublingRangeModint, 1000) {
+  fast_fibonacci<mint> fib;
+  std::vector<mint> out(state.arg());
+  while (state.run()) {
+    fib.range(1U << 30, state.arg(), out.begin());
+    do_not_optimize(out);
+  }
+}
+
+BENCH(TableModint, 1LL << 10, 1LL << 20, 1LL << 31) {
+  constexpr static fibonacci_table<mint> table;
+  unsigned n = state.arg() - 1;
+  while (state.run()) {
+    do_not_optimize(table.nth(n));
+  }
+}
@@ -1,4 +1,7 @@
 #include "gtest/gtest.h"
+#include <iterator>
+#include "bigint.h"
+#include "modint.h"
 #include "fibonacci.h"
 
 TEST(FibonacciTest, Int) {
@@ -18,3 +21,81 @@ TEST(FibonacciTest, UnsignedChar) {
 }
 
 
+
+TEST(FastFibonacciTest, Int) {
+  fast_fibonacci<int> fib;
+  int ans[16] = {0, 1, 1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 377, 610};
+  for (int i = 0; i < 16; i++) {
+    EXPECT_EQ(ans[i], fib.nth(i));
+  }
+}
+
+TEST(FastFibonacciTest, UnsignedChar) {
+  fast_fibonacci<unsigned char> fib;
+  int ans[16] = {0, 1, 1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 121, 98};
+  for (int i = 0; i < 16; i++) {
+    EXPECT_EQ(ans[i], fib.nth(i));
+  }
+}
+
+TEST(FastFibonacciTest, MatchesMatrix) {
+  typedef modint<1000000007> mint;
+  fibonacci<mint> slow(4000000000U);
+  fast_fibonacci<mint> fast;
+  unsigned n[5] = {2, 3, 1000, 123456789U, 3999999999U};
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(static_cast<int>(slow.nth(n[i])),
+              static_cast<int>(fast.nth(n[i])));
+  }
+}
+
+TEST(FastFibonacciTest, Bigint) {
+  fast_fibonacci<bigint> fib;
+  EXPECT_EQ(bigint("354224848179261915075"), fib.nth(100));
+  EXPECT_EQ(bigint("1"), fib.nth(1));
+}
+
+TEST(FastFibonacciTest, SortedBatch) {
+  typedef modint<1000000007> mint;
+  fast_fibonacci<mint> fib;
+  std::vector<long long> n;
+  long long values[7] = {0, 1, 5, 6, 100, 100, 1000000000000LL};
+  n.assign(values, values + 7);
+  std::vector<mint> out;
+  fib.nth(n, out);
+  ASSERT_EQ(7U, out.size());
+  for (int i = 0; i < 7; i++) {
+    EXPECT_EQ(static_cast<int>(fib.nth(n[i])), static_cast<int>(out[i]));
+  }
+}
+
+TEST(FastFibonacciTest, Range) {
+  fast_fibonacci<bigint> fib;
+  std::vector<bigint> out;
+  fib.range(98, 3, std::back_inserter(out));
+  ASSERT_EQ(3U, out.size());
+  EXPECT_EQ(bigint("135301852344706746049"), out[0]);
+  EXPECT_EQ(bigint("218922995834555169026"), out[1]);
+  EXPECT_EQ(bigint("354224848179261915075"), out[2]);
+}
+
+TEST(FibonacciTableTest, Small) {
+  constexpr static fibonacci_table<unsigned long long, 94> table;
+  static_assert(table[10] == 55, "F(10)");
+  static_assert(table.nth(93) == 12200160415121876738ULL, "F(93)");
+  fast_fibonacci<unsigned long long> fib;
+  for (int i = 0; i < 94; i++) {
+    EXPECT_EQ(fib.nth(i), table[i]);
+  }
+}
+
+TEST(FibonacciTableTest, Modint) {
+  typedef modint<1000000007> mint;
+  constexpr static fibonacci_table<mint> table;
+  fast_fibonacci<mint> fib;
+  unsigned long long n = 1;
+  for (int i = 0; i < 200; i++, n = n * 3 + i) {
+    EXPECT_EQ(fib.nth(n), table.nth(n));
+  }
+  EXPECT_EQ(fib.nth(~0ULL), table.nth(~0ULL));
+}
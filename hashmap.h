@@ -0,0 +1,419 @@
+#ifndef HASHMAP_H
+#define HASHMAP_H
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//reserve flat_hash_map flat_hash_set FastHash reserve
+
+// Default hashes for the tables. The tables apply Fibonacci hashing (one
+// multiply) to any hash before taking its top bits, so integers hash to
+// themselves; pairs mix both halves into one word, other types mix the
+// result of std::hash.
+template<typename T, typename Enable = void>
+struct FastHash {
+  size_t operator()(const T& x) const {
+    unsigned long long h = std::hash<T>()(x);
+    return h ^ (h >> 32);
+  }
+};
+
+template<typename T>
+struct FastHash<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+  size_t operator()(const T& x) const {
+    return static_cast<unsigned long long>(x);
+  }
+};
+
+template<typename A, typename B>
+struct FastHash<std::pair<A, B> > {
+  size_t operator()(const std::pair<A, B>& x) const {
+    unsigned long long h = FastHash<A>()(x.first) * 0xbf58476d1ce4e5b9ULL;
+    return (h ^ (h >> 31)) + FastHash<B>()(x.second);
+  }
+};
+
+// Open addressing with Robin Hood probing: an insert displaces entries that
+// sit closer to their home slot than the new one, so probe lengths stay
+// short and a lookup stops as soon as it meets an entry closer to home than
+// the key would be. Erase shifts the following entries back instead of
+// leaving tombstones. Entries live in one flat array, with a parallel array
+// holding probe distance + 1 (0 for an empty slot).
+//
+// Entries are stored as Stored, which must be assignable, and handed out as
+// Value, which has the same layout: for maps these are pair<Key, T> and
+// pair<const Key, T>.
+template<typename Key, typename Value, typename Stored, typename KeyOf,
+         typename Hash, typename Equal>
+class RobinHoodTable {
+ public:
+  // Iteration starts after an empty slot and wraps around to it, so a
+  // cluster that wraps past the end of the array is visited in order, and
+  // erasing shifts only entries not visited yet.
+  template<typename Table, typename V>
+  class basic_iterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef V value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef V* pointer;
+    typedef V& reference;
+
+    basic_iterator() : table_(NULL), index_(0), stop_(0) {}
+    basic_iterator(Table* table, size_t index, size_t stop = UNKNOWN)
+        : table_(table), index_(index), stop_(stop) {}
+    template<typename T, typename U>
+    basic_iterator(const basic_iterator<T, U>& b)
+        : table_(b.table_), index_(b.index_), stop_(b.stop_) {}
+
+    V& operator*() const {
+      return reinterpret_cast<V&>(table_->slots_[index_]);
+    }
+    V* operator->() const {
+      return &**this;
+    }
+    basic_iterator& operator++() {
+      if (stop_ == UNKNOWN) {
+        stop_ = table_->first_empty();
+      }
+      size_t mask = table_->distance_.size() - 1;
+      do {
+        index_ = (index_ + 1) & mask;
+      } while (index_ != stop_ && table_->distance_[index_] == 0);
+      if (index_ == stop_) {
+        index_ = table_->distance_.size();
+      }
+      return *this;
+    }
+    basic_iterator operator++(int) {
+      basic_iterator old(*this);
+      ++*this;
+      return old;
+    }
+    bool operator==(const basic_iterator& b) const {
+      return index_ == b.index_;
+    }
+    bool operator!=(const basic_iterator& b) const {
+      return index_ != b.index_;
+    }
+
+   private:
+    template<typename T, typename U> friend class basic_iterator;
+    friend class RobinHoodTable;
+
+    static const size_t UNKNOWN = ~size_t(0);
+
+    Table* table_;
+    size_t index_, stop_;
+  };
+
+  typedef Key key_type;
+  typedef Value value_type;
+  typedef basic_iterator<RobinHoodTable, Value> iterator;
+  typedef basic_iterator<const RobinHoodTable, const Value> const_iterator;
+
+  RobinHoodTable() : size_(0), shift_(64) {}
+
+  iterator begin() {
+    return size_ == 0 ? end() : ++iterator(this, first_empty(), first_empty());
+  }
+  iterator end() {
+    return iterator(this, distance_.size());
+  }
+  const_iterator begin() const {
+    return size_ == 0 ? end() :
+        ++const_iterator(this, first_empty(), first_empty());
+  }
+  const_iterator end() const {
+    return const_iterator(this, distance_.size());
+  }
+
+  size_t size() const {
+    return size_;
+  }
+  bool empty() const {
+    return size_ == 0;
+  }
+  size_t bucket_count() const {
+    return distance_.size();
+  }
+
+  // Room for n entries without rehashing.
+  void reserve(size_t n) {
+    size_t capacity = 8;
+    while (capacity * MAX_LOAD_NUM < n * MAX_LOAD_DEN) {
+      capacity *= 2;
+    }
+    if (capacity > distance_.size()) {
+      rehash(capacity);
+    }
+  }
+
+  void clear() {
+    for (size_t i = 0; i < distance_.size(); i++) {
+      if (distance_[i] != 0) {
+        slots_[i] = Stored();
+        distance_[i] = 0;
+      }
+    }
+    size_ = 0;
+  }
+
+  iterator find(const Key& key) {
+    return iterator(this, locate(key));
+  }
+  const_iterator find(const Key& key) const {
+    return const_iterator(this, locate(key));
+  }
+
+  size_t count(const Key& key) const {
+    return locate(key) != distance_.size();
+  }
+
+  std::pair<iterator, bool> insert(const Value& value) {
+    std::pair<size_t, bool> found = emplace(KeyOf()(value), Copy(value));
+    return std::make_pair(iterator(this, found.first), found.second);
+  }
+
+  template<typename InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  size_t erase(const Key& key) {
+    size_t index = locate(key);
+    if (index == distance_.size()) {
+      return 0;
+    }
+    remove(index);
+    return 1;
+  }
+
+  // The entry after it in the iteration shifts into its slot, if any.
+  iterator erase(const_iterator it) {
+    size_t stop = it.stop_ == it.UNKNOWN ? first_empty() : it.stop_;
+    remove(it.index_);
+    iterator next(this, it.index_, stop);
+    if (distance_[it.index_] == 0) {
+      ++next;
+    }
+    return next;
+  }
+
+  void swap(RobinHoodTable& b) {
+    slots_.swap(b.slots_);
+    distance_.swap(b.distance_);
+    std::swap(size_, b.size_);
+    std::swap(shift_, b.shift_);
+  }
+
+ protected:
+  struct Copy {
+    explicit Copy(const Value& value) : value_(value) {}
+    Stored operator()() const {
+      return Stored(value_);
+    }
+    const Value& value_;
+  };
+
+  size_t locate(const Key& key) const {
+    if (size_ == 0) {
+      return distance_.size();
+    }
+    size_t mask = distance_.size() - 1;
+    size_t index = home(key);
+    for (unsigned d = 1; distance_[index] >= d; d++) {
+      if (distance_[index] == d && Equal()(KeyOf()(slots_[index]), key)) {
+        return index;
+      }
+      index = (index + 1) & mask;
+    }
+    return distance_.size();
+  }
+
+  // Finds key, or inserts the entry built by make(); returns the slot and
+  // whether it was inserted. A missing key's probe goes on into the insert.
+  template<typename Make>
+  std::pair<size_t, bool> emplace(const Key& key, Make make) {
+    if ((size_ + 1) * MAX_LOAD_DEN > distance_.size() * MAX_LOAD_NUM) {
+      size_t index = locate(key);
+      if (index != distance_.size()) {
+        return std::make_pair(index, false);
+      }
+      grow();
+    }
+    size_t mask = distance_.size() - 1;
+    size_t index = home(key);
+    unsigned d = 1;
+    for (; distance_[index] >= d; d++) {
+      if (distance_[index] == d && Equal()(KeyOf()(slots_[index]), key)) {
+        return std::make_pair(index, false);
+      }
+      index = (index + 1) & mask;
+    }
+    return std::make_pair(place(index, d, make()), true);
+  }
+
+  // Puts an absent entry at index, where its probe reached distance d,
+  // displacing richer entries; returns where it landed.
+  size_t place(size_t index, unsigned d, Stored value) {
+    size_t mask = distance_.size() - 1;
+    size_t landed = distance_.size();
+    while (true) {
+      if (distance_[index] == 0) {
+        slots_[index] = std::move(value);
+        distance_[index] = d;
+        size_++;
+        return landed == distance_.size() ? index : landed;
+      }
+      if (distance_[index] < d) {
+        std::swap(slots_[index], value);
+        unsigned carried = distance_[index];
+        distance_[index] = d;
+        d = carried;
+        if (landed == distance_.size()) {
+          landed = index;
+        }
+      }
+      index = (index + 1) & mask;
+      d++;
+    }
+  }
+
+  void remove(size_t index) {
+    size_t mask = distance_.size() - 1;
+    size_t next = (index + 1) & mask;
+    while (distance_[next] > 1) {
+      slots_[index] = std::move(slots_[next]);
+      distance_[index] = distance_[next] - 1;
+      index = next;
+      next = (next + 1) & mask;
+    }
+    slots_[index] = Stored();
+    distance_[index] = 0;
+    size_--;
+  }
+
+  // The load stays under 7/8, so there is always an empty slot.
+  size_t first_empty() const {
+    size_t index = 0;
+    while (distance_[index] != 0) {
+      index++;
+    }
+    return index;
+  }
+
+  // Small tables grow 4x: every rehash reinserts all entries, and that
+  // dominates building a table one insert at a time.
+  void grow() {
+    size_t capacity = distance_.size();
+    rehash(capacity == 0 ? 8 : capacity < GROW_4X ? 4 * capacity :
+           2 * capacity);
+  }
+
+  // The home slot is the top bits of the hash, so the entries of a slot
+  // move to consecutive slots of the larger table, in order.
+  void rehash(size_t capacity) {
+    std::vector<Stored> slots(capacity);
+    std::vector<unsigned> distance(capacity, 0);
+    slots.swap(slots_);
+    distance.swap(distance_);
+    shift_ = 64;
+    for (size_t c = capacity; c > 1; c >>= 1) {
+      shift_--;
+    }
+    size_ = 0;
+    for (size_t i = 0; i < distance.size(); i++) {
+      if (distance[i] != 0) {
+        place(home(KeyOf()(slots[i])), 1, std::move(slots[i]));
+      }
+    }
+  }
+
+  // Fibonacci hashing: the multiply carries every bit of the hash into the
+  // top bits, so identity hashes such as std::hash<int> spread out too.
+  size_t home(const Key& key) const {
+    return static_cast<unsigned long long>(Hash()(key)) *
+        0x9e3779b97f4a7c15ULL >> shift_ & (distance_.size() - 1);
+  }
+
+  static const size_t MAX_LOAD_NUM = 7, MAX_LOAD_DEN = 8, GROW_4X = 1 << 16;
+
+  std::vector<Stored> slots_;
+  // 32 bits, since a degenerate hash can push one cluster past 65535.
+  std::vector<unsigned> distance_;
+  size_t size_;
+  int shift_;
+};
+
+template<typename Key>
+struct SetKey {
+  const Key& operator()(const Key& key) const {
+    return key;
+  }
+};
+
+template<typename Key, typename T>
+struct MapKey {
+  const Key& operator()(const std::pair<Key, T>& value) const {
+    return value.first;
+  }
+  const Key& operator()(const std::pair<const Key, T>& value) const {
+    return value.first;
+  }
+};
+
+// Drop-in for unordered_map in the common cases. Entries are
+// std::pair<const Key, T>, and iterators and references are invalidated by
+// any insert or erase.
+template<typename Key, typename T, typename Hash = FastHash<Key>,
+         typename Equal = std::equal_to<Key> >
+class flat_hash_map : public RobinHoodTable<
+    Key, std::pair<const Key, T>, std::pair<Key, T>, MapKey<Key, T>, Hash,
+    Equal> {
+ public:
+  typedef T mapped_type;
+
+  T& operator[](const Key& key) {
+    return this->slots_[this->emplace(key, Default(key)).first].second;
+  }
+
+  T& at(const Key& key) {
+    size_t index = this->locate(key);
+    if (index == this->distance_.size()) {
+      throw std::out_of_range("flat_hash_map::at");
+    }
+    return this->slots_[index].second;
+  }
+
+  const T& at(const Key& key) const {
+    size_t index = this->locate(key);
+    if (index == this->distance_.size()) {
+      throw std::out_of_range("flat_hash_map::at");
+    }
+    return this->slots_[index].second;
+  }
+
+ private:
+  struct Default {
+    explicit Default(const Key& key) : key_(key) {}
+    std::pair<Key, T> operator()() const {
+      return std::pair<Key, T>(key_, T());
+    }
+    const Key& key_;
+  };
+};
+
+template<typename Key, typename Hash = FastHash<Key>,
+         typename Equal = std::equal_to<Key> >
+class flat_hash_set
+    : public RobinHoodTable<Key, Key, Key, SetKey<Key>, Hash, Equal> {
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include <unordered_map>
+#include <vector>
+#include <tr1/unordered_map>
+#include "bench.h"
+#include "hashmap.h"
+
+typedef std::pair<int, int> pii;
+
+std::vector<long long> random_keys(int n, unsigned seed) {
+  std::vector<long long> keys(n);
+  for (int i = 0; i < n; i++) {
+    seed = seed * 1103515245 + 12345;
+    keys[i] = (long long)(seed >> 4) * 1000003;
+  }
+  return keys;
+}
+
+template<typename Map>
+void insert(BenchState& state) {
+  std::vector<long long> keys = random_keys(state.arg(), 1);
+  while (state.run()) {
+    Map m;
+    for (unsigned i = 0; i < keys.size(); i++) {
+      m[keys[i]] = i;
+    }
+    do_not_optimize(m);
+  }
+}
+
+// Half of the lookups hit, half miss.
+template<typename Map>
+void lookup(BenchState& state) {
+  std::vector<long long> keys = random_keys(state.arg(), 1);
+  std::vector<long long> other = random_keys(state.arg(), 2);
+  Map m;
+  for (unsigned i = 0; i < keys.size(); i++) {
+    m[keys[i]] = i;
+  }
+  while (state.run()) {
+    int found = 0;
+    for (unsigned i = 0; i < keys.size(); i++) {
+      found += m.count(keys[i]) + m.count(other[i]);
+    }
+    do_not_optimize(found);
+  }
+}
+
+// Grid DP memo: pii keys, one lookup and one insert per cell.
+template<typename Map>
+void grid(BenchState& state) {
+  int n = state.arg();
+  while (state.run()) {
+    Map m;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        typename Map::iterator up = m.find(pii(i - 1, j));
+        m[pii(i, j)] = up == m.end() ? 1 : up->second + 1;
+      }
+    }
+    do_not_optimize(m);
+  }
+}
+
+struct PairHash {
+  size_t operator()(const pii& x) const {
+    return std::hash<long long>()((long long)x.first << 32 | x.second);
+  }
+};
+
+typedef std::tr1::unordered_map<long long, int> tr1_map;
+typedef std::unordered_map<long long, int> std_map;
+typedef flat_hash_map<long long, int> flat_map;
+
+BENCH(InsertTr1, 1 << 10, 1 << 16, 1 << 20) { insert<tr1_map>(state); }
+BENCH(InsertStd, 1 << 10, 1 << 16, 1 << 20) { insert<std_map>(state); }
+BENCH(InsertFlat, 1 << 10, 1 << 16, 1 << 20) { insert<flat_map>(state); }
+
+BENCH(LookupTr1, 1 << 10, 1 << 16, 1 << 20) { lookup<tr1_map>(state); }
+BENCH(LookupStd, 1 << 10, 1 << 16, 1 << 20) { lookup<std_map>(state); }
+BENCH(LookupFlat, 1 << 10, 1 << 16, 1 << 20) { lookup<flat_map>(state); }
+
+BENCH(GridTr1, 300) {
+  grid<std::tr1::unordered_map<pii, int, PairHash> >(state);
+}
+// With the identity-like PairHash, row-major keys land in consecutive tr1
+// buckets, which favors this access pattern; FastHash scatters them.
+BENCH(GridTr1FastHash, 300) {
+  grid<std::tr1::unordered_map<pii, int, FastHash<pii> > >(state);
+}
+BENCH(GridFlat, 300) { grid<flat_hash_map<pii, int> >(state); }
+
+BENCH(InsertFlatReserved, 1 << 10, 1 << 16, 1 << 20) {
+  std::vector<long long> keys = random_keys(state.arg(), 1);
+  while (state.run()) {
+    flat_map m;
+    m.reserve(keys.size());
+    for (unsigned i = 0; i < keys.size(); i++) {
+      m[keys[i]] = i;
+    }
+    do_not_optimize(m);
+  }
+}
@@ -0,0 +1,209 @@
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "lazy.h"
+#include "hashmap.h"
+
+TEST(FlatHashMapTest, Basic) {
+  flat_hash_map<int, int> m;
+  EXPECT_TRUE(m.empty());
+  m[3] = 30;
+  m[5] = 50;
+  m[3] += 1;
+  EXPECT_EQ(2u, m.size());
+  EXPECT_EQ(31, m[3]);
+  EXPECT_EQ(50, m.at(5));
+  EXPECT_EQ(0, m[7]);
+  EXPECT_EQ(3u, m.size());
+  EXPECT_EQ(1u, m.count(5));
+  EXPECT_EQ(0u, m.count(6));
+  EXPECT_TRUE(m.find(6) == m.end());
+  EXPECT_EQ(50, m.find(5)->second);
+  EXPECT_FALSE(m.insert(make_pair(5, 0)).second);
+  EXPECT_TRUE(m.insert(make_pair(6, 60)).second);
+  EXPECT_EQ(60, m.insert(make_pair(6, 0)).first->second);
+  EXPECT_EQ(1u, m.erase(5));
+  EXPECT_EQ(0u, m.erase(5));
+  EXPECT_THROW(m.at(5), std::out_of_range);
+  m.clear();
+  EXPECT_EQ(0u, m.size());
+  EXPECT_TRUE(m.find(3) == m.end());
+}
+
+TEST(FlatHashMapTest, MatchesStdMap) {
+  flat_hash_map<llint, int> m;
+  map<llint, int> expected;
+  unsigned seed = 12345;
+  for (int i = 0; i < 200000; i++) {
+    seed = seed * 1103515245 + 12345;
+    llint key = (seed >> 8) % 5000 * 1000000007LL;
+    switch (seed % 4) {
+      case 0:
+      case 1:
+        m[key] = i;
+        expected[key] = i;
+        break;
+      case 2:
+        EXPECT_EQ(expected.erase(key), m.erase(key));
+        break;
+      case 3:
+        EXPECT_EQ(expected.count(key), m.count(key));
+        break;
+    }
+  }
+  EXPECT_EQ(expected.size(), m.size());
+  map<llint, int> contents(m.begin(), m.end());
+  EXPECT_TRUE(expected == contents);
+}
+
+TEST(FlatHashMapTest, Keys) {
+  flat_hash_map<pii, int> grid;
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < 100; j++) {
+      grid[pii(i, j)] = i * j;
+    }
+  }
+  EXPECT_EQ(10000u, grid.size());
+  EXPECT_EQ(42 * 17, grid[pii(42, 17)]);
+  flat_hash_map<string, int> words;
+  words["ricbit"]++;
+  words["ilafox"]++;
+  words["ricbit"]++;
+  EXPECT_EQ(2, words["ricbit"]);
+  EXPECT_EQ(1, words["ilafox"]);
+  EXPECT_EQ(2u, words.size());
+}
+
+TEST(FlatHashMapTest, Reserve) {
+  flat_hash_map<int, int> m;
+  m.reserve(1000);
+  size_t buckets = m.bucket_count();
+  for (int i = 0; i < 1000; i++) {
+    m[i * 7919] = i;
+  }
+  EXPECT_EQ(buckets, m.bucket_count());
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(i, m[i * 7919]);
+  }
+}
+
+// A constant hash puts every key in one cluster: slow, but still correct,
+// and every key stays reachable by lookup and by iteration.
+struct BadHash {
+  size_t operator()(int x) const {
+    return 0;
+  }
+};
+
+TEST(FlatHashMapTest, BadHash) {
+  flat_hash_map<int, int, BadHash> m;
+  for (int i = 0; i < 3000; i++) {
+    EXPECT_EQ(i, m.insert(make_pair(i, i)).first->first);
+  }
+  for (int i = 0; i < 3000; i++) {
+    EXPECT_EQ(i, m[i]);
+  }
+  EXPECT_EQ(3000u, m.size());
+  EXPECT_EQ(3000, std::distance(m.begin(), m.end()));
+}
+
+// std::hash<int> is the identity in libstdc++; the table mixes it, so
+// sequential keys do not pile up in slot 0.
+TEST(FlatHashMapTest, IdentityHash) {
+  flat_hash_map<int, int, std::hash<int> > m;
+  for (int i = 0; i < 300000; i++) {
+    m[i] = i;
+  }
+  EXPECT_EQ(300000u, m.size());
+  for (int i = 0; i < 300000; i += 997) {
+    EXPECT_EQ(i, m[i]);
+  }
+  EXPECT_EQ(0u, m.count(300000));
+}
+
+// Homes every key in the last slot, so the cluster wraps to the front:
+// the table's Fibonacci multiply turns this constant into ~0.
+struct LastSlotHash {
+  size_t operator()(int x) const {
+    return 0x0e217c1e66c88cc3ULL;
+  }
+};
+
+TEST(FlatHashMapTest, EraseWhileIterating) {
+  flat_hash_map<int, int, LastSlotHash> wrapped;
+  flat_hash_map<int, int> spread;
+  for (int i = 0; i < 50; i++) {
+    wrapped[i] = i;
+  }
+  for (int i = 0; i < 10000; i++) {
+    spread[i * 7919] = i;
+  }
+  // Each entry is visited once, even when erasing shifts the others back.
+  int visits = 0;
+  for (flat_hash_map<int, int, LastSlotHash>::iterator it = wrapped.begin();
+       it != wrapped.end(); visits++) {
+    it = it->second % 3 ? wrapped.erase(it) : ++it;
+  }
+  EXPECT_EQ(50, visits);
+  EXPECT_EQ(17u, wrapped.size());
+  visits = 0;
+  for (flat_hash_map<int, int>::iterator it = spread.begin();
+       it != spread.end(); visits++) {
+    it = it->second % 2 ? spread.erase(it) : ++it;
+  }
+  EXPECT_EQ(10000, visits);
+  EXPECT_EQ(5000u, spread.size());
+  for (int i = 0; i < 10000; i++) {
+    EXPECT_EQ(i % 2 == 0, spread.count(i * 7919) == 1);
+  }
+}
+
+TEST(FlatHashMapTest, ConstKey) {
+  typedef flat_hash_map<int, int> map_type;
+  EXPECT_TRUE((std::is_same<std::pair<const int, int>,
+                            map_type::value_type>::value));
+  EXPECT_TRUE((std::is_same<std::pair<const int, int>&,
+                            decltype(*map_type().begin())>::value));
+  map_type m;
+  m.insert(map_type::value_type(1, 10));
+  m.insert(make_pair(2, 20));
+  map_type::const_iterator it = m.find(2);
+  EXPECT_EQ(2, it->first);
+  EXPECT_EQ(20, it->second);
+  m.begin()->second++;
+  EXPECT_EQ(31, m[1] + m[2]);
+}
+
+TEST(FlatHashSetTest, MatchesStdSet) {
+  flat_hash_set<int> s;
+  set<int> expected;
+  unsigned seed = 12345;
+  for (int i = 0; i < 100000; i++) {
+    seed = seed * 1103515245 + 12345;
+    int key = (seed >> 8) % 3000;
+    if (seed % 3) {
+      EXPECT_EQ(expected.insert(key).second, s.insert(key).second);
+    } else {
+      EXPECT_EQ(expected.erase(key), s.erase(key));
+    }
+  }
+  EXPECT_EQ(expected, set<int>(s.begin(), s.end()));
+  flat_hash_set<int>::const_iterator it = s.find(*expected.begin());
+  ASSERT_TRUE(it != s.end());
+  s.erase(it);
+  EXPECT_EQ(expected.size() - 1, s.size());
+}
+
+TEST(LazyTest, HashMapNames) {
+  hash_map<int, int> m;
+  hash_set<int> s;
+  m[1] = 2;
+  s.insert(3);
+  EXPECT_EQ(2, m[1]);
+  EXPECT_EQ(1u, s.count(3));
+  EXPECT_TRUE((std::is_same<hash_map<int, int>,
+                            flat_hash_map<int, int> >::value));
+  EXPECT_TRUE((std::is_same<hash_set<int>, flat_hash_set<int> >::value));
+}
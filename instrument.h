@@ -0,0 +1,217 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <memory>
+
+//reserve INSTRUMENT_COUNT INSTRUMENT_TIMER INSTRUMENT_ALLOCATOR Instrument
+
+// Opt-in counters and timers for the library. Compile with
+// -DSPOJLIB_INSTRUMENT to enable them; otherwise every macro expands to
+// nothing and INSTRUMENT_ALLOCATOR is plain std::allocator, so the hooks
+// can stay in the code for free.
+//
+//   INSTRUMENT_COUNT("bigint.divmul", 1);   adds to a named counter.
+//   INSTRUMENT_TIMER("matrix.power");       times the enclosing scope.
+//   INSTRUMENT_CONSTEXPR_COUNT("modint.reductions", 1);
+//                                           same as INSTRUMENT_COUNT, for
+//                                           constexpr functions; nothing is
+//                                           counted at compile time, and
+//                                           only gcc and clang count at all.
+//   std::vector<int, INSTRUMENT_ALLOCATOR(int, Bigint)>
+//                                           counts "bigint.allocations" and
+//                                           "bigint.bytes".
+//
+// Counters are printed to stderr at exit, or on demand with
+// Instrument::get().dump(file). They are atomic, so threads may share them.
+
+#ifdef SPOJLIB_INSTRUMENT
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+
+struct InstrumentCounter {
+  InstrumentCounter() : count(0), nanoseconds(0) {}
+  std::atomic<long long> count, nanoseconds;
+};
+
+class Instrument {
+ public:
+  static Instrument& get() {
+    static Instrument instance;
+    return instance;
+  }
+
+  // The reference stays valid for the whole run, since map nodes never move.
+  InstrumentCounter& counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_[name];
+  }
+
+  long long count(const std::string& name) {
+    return counter(name).count;
+  }
+
+  long long nanoseconds(const std::string& name) {
+    return counter(name).nanoseconds;
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& it : counters_) {
+      it.second.count = 0;
+      it.second.nanoseconds = 0;
+    }
+  }
+
+  void dump(FILE* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& it : counters_) {
+      if (it.second.count == 0) {
+        continue;
+      }
+      fprintf(out, "%-32s %16lld", it.first.c_str(),
+              it.second.count.load());
+      if (it.second.nanoseconds > 0) {
+        fprintf(out, " %14.3f ms", it.second.nanoseconds * 1e-6);
+      }
+      fprintf(out, "\n");
+    }
+  }
+
+  ~Instrument() {
+    dump(stderr);
+  }
+
+ private:
+  Instrument() {}
+
+  std::mutex mutex_;
+  std::map<std::string, InstrumentCounter> counters_;
+};
+
+// Counter for constexpr functions, which cannot hold a static themselves.
+// Site is a local class naming the counter, so each call site keeps its own
+// static reference, as INSTRUMENT_COUNT does.
+template<typename Site>
+void instrument_count(long long n) {
+  static InstrumentCounter& counter = Instrument::get().counter(Site::label());
+  counter.count.fetch_add(n, std::memory_order_relaxed);
+}
+
+// Adds the lifetime of the object to the counter's time, and one call.
+class InstrumentTimer {
+ public:
+  explicit InstrumentTimer(InstrumentCounter& counter)
+      : counter_(counter), start_(clock::now()) {}
+
+  ~InstrumentTimer() {
+    counter_.count.fetch_add(1, std::memory_order_relaxed);
+    counter_.nanoseconds.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock::now() - start_).count(),
+        std::memory_order_relaxed);
+  }
+
+ private:
+  typedef std::chrono::steady_clock clock;
+
+  InstrumentCounter& counter_;
+  clock::time_point start_;
+};
+
+template<typename T, typename Group>
+class InstrumentAllocator : public std::allocator<T> {
+ public:
+  template<typename U>
+  struct rebind {
+    typedef InstrumentAllocator<U, Group> other;
+  };
+
+  InstrumentAllocator() {}
+
+  template<typename U>
+  InstrumentAllocator(const InstrumentAllocator<U, Group>& b) {}
+
+  T* allocate(size_t n, const void* hint = 0) {
+    static InstrumentCounter& allocations =
+        Instrument::get().counter(std::string(Group::name()) + ".allocations");
+    static InstrumentCounter& bytes =
+        Instrument::get().counter(std::string(Group::name()) + ".bytes");
+    allocations.count.fetch_add(1, std::memory_order_relaxed);
+    bytes.count.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+    return std::allocator<T>::allocate(n);
+  }
+
+  template<typename U>
+  bool operator==(const InstrumentAllocator<U, Group>& b) const {
+    return true;
+  }
+
+  template<typename U>
+  bool operator!=(const InstrumentAllocator<U, Group>& b) const {
+    return false;
+  }
+};
+
+struct InstrumentBigint {
+  static const char* name() { return "bigint"; }
+};
+
+struct InstrumentMatrix {
+  static const char* name() { return "matrix"; }
+};
+
+#define INSTRUMENT_JOIN2(a, b) a##b
+#define INSTRUMENT_JOIN(a, b) INSTRUMENT_JOIN2(a, b)
+
+#define INSTRUMENT_COUNT(name, n) do { \
+    static InstrumentCounter& instrument_counter = \
+        Instrument::get().counter(name); \
+    instrument_counter.count.fetch_add((n), std::memory_order_relaxed); \
+  } while (0)
+
+// Constant evaluation is told apart with a compiler builtin (gcc 9, clang
+// 9); other compilers leave constexpr functions uncounted.
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define INSTRUMENT_RUNTIME() !__builtin_is_constant_evaluated()
+#endif
+#elif defined(__GNUC__) && __GNUC__ >= 9
+#define INSTRUMENT_RUNTIME() !__builtin_is_constant_evaluated()
+#endif
+
+#ifdef INSTRUMENT_RUNTIME
+#define INSTRUMENT_CONSTEXPR_COUNT(name, n) do { \
+    struct instrument_site { \
+      static const char* label() { return name; } \
+    }; \
+    if (INSTRUMENT_RUNTIME()) { \
+      instrument_count<instrument_site>(n); \
+    } \
+  } while (0)
+#else
+#define INSTRUMENT_CONSTEXPR_COUNT(name, n) do {} while (0)
+#endif
+
+#define INSTRUMENT_TIMER(name) \
+  static InstrumentCounter& INSTRUMENT_JOIN(instrument_timer_, __LINE__) = \
+      Instrument::get().counter(name); \
+  InstrumentTimer INSTRUMENT_JOIN(instrument_scope_, __LINE__)( \
+      INSTRUMENT_JOIN(instrument_timer_, __LINE__))
+
+#define INSTRUMENT_ALLOCATOR(T, Group) InstrumentAllocator<T, Instrument##Group>
+
+#else
+
+#define INSTRUMENT_COUNT(name, n) do {} while (0)
+#define INSTRUMENT_CONSTEXPR_COUNT(name, n) do {} while (0)
+#define INSTRUMENT_TIMER(name) do {} while (0)
+#define INSTRUMENT_ALLOCATOR(T, Group) std::allocator<T>
+
+#endif
+
+#endif
@@ -0,0 +1,120 @@
+#define SPOJLIB_INSTRUMENT
+#include <string>
+#include "gtest/gtest.h"
+#include "bigint.h"
+#include "modint.h"
+#include "matrix.h"
+#include "io.h"
+
+class StringIO {
+ public:
+  static std::string input, output;
+  static int pos;
+
+  int read(char* buffer, int size) {
+    int length = std::min<int>(size, input.size() - pos);
+    memcpy(buffer, input.data() + pos, length);
+    pos += length;
+    return length;
+  }
+
+  void write(char* buffer, int size) {
+    output.append(buffer, size);
+  }
+};
+
+std::string StringIO::input, StringIO::output;
+int StringIO::pos = 0;
+
+TEST(InstrumentTest, Count) {
+  Instrument::get().reset();
+  for (int i = 0; i < 10; i++) {
+    INSTRUMENT_COUNT("test.count", i);
+  }
+  EXPECT_EQ(45, Instrument::get().count("test.count"));
+  Instrument::get().reset();
+  EXPECT_EQ(0, Instrument::get().count("test.count"));
+}
+
+TEST(InstrumentTest, Timer) {
+  Instrument::get().reset();
+  for (int i = 0; i < 3; i++) {
+    INSTRUMENT_TIMER("test.timer");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(3, Instrument::get().count("test.timer"));
+  EXPECT_LE(3000000, Instrument::get().nanoseconds("test.timer"));
+}
+
+TEST(InstrumentTest, Threads) {
+  Instrument::get().reset();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([] {
+      for (int i = 0; i < 10000; i++) {
+        INSTRUMENT_COUNT("test.threads", 1);
+      }
+    }));
+  }
+  for (unsigned t = 0; t < threads.size(); t++) {
+    threads[t].join();
+  }
+  EXPECT_EQ(40000, Instrument::get().count("test.threads"));
+}
+
+TEST(InstrumentTest, Bigint) {
+  bigint a("123456789123456789123456789"), b("987654321987654321");
+  Instrument::get().reset();
+  bigint c = a * b;
+  // Schoolbook: one divmul per limb of b times (limbs of a + 1).
+  EXPECT_EQ(2 * (3 + 1), Instrument::get().count("bigint.divmul"));
+  EXPECT_EQ(1, Instrument::get().count("bigint.multiply"));
+  EXPECT_LE(1, Instrument::get().count("bigint.allocations"));
+  EXPECT_LE(6 * sizeof(int), Instrument::get().count("bigint.bytes"));
+  EXPECT_EQ("121932631356500531469135800347203169112635269",
+            std::string(c));
+}
+
+TEST(InstrumentTest, Modint) {
+  typedef modint<1000000007> mint;
+  Instrument::get().reset();
+  mint a(2), b(3);
+  mint c = a * b * a;
+  EXPECT_EQ(2, Instrument::get().count("modint.reductions"));
+  EXPECT_EQ(12, int(c));
+  a.inverse();
+  EXPECT_EQ(1, Instrument::get().count("modint.inverses"));
+}
+
+TEST(InstrumentTest, Matrix) {
+  const static int a[] = {1, 1, 1, 0};
+  matrix<long long> m(2, 2, a);
+  Instrument::get().reset();
+  matrix<long long> f = m.power(10);
+  EXPECT_EQ(89, f[0][0]);
+  EXPECT_EQ(1, Instrument::get().count("matrix.power"));
+  // 10 = 1010b: four squarings and two products of 2x2 matrices.
+  EXPECT_EQ(6 * 8, Instrument::get().count("matrix.multiply_adds"));
+  EXPECT_LT(0, Instrument::get().count("matrix.allocations"));
+}
+
+TEST(InstrumentTest, Fastio) {
+  StringIO::input = std::string(100000, '7') + " 42\n";
+  StringIO::pos = 0;
+  StringIO::output.clear();
+  Instrument::get().reset();
+  {
+    _fastio<1024, 20, StringIO> io;
+    EXPECT_EQ(100000u, io.word().size);
+    int x = io;
+    EXPECT_EQ(42, x);
+    io << x << "\n";
+  }
+  EXPECT_EQ(int(StringIO::input.size()),
+            Instrument::get().count("fastio.bytes_read"));
+  EXPECT_LT(1, Instrument::get().count("fastio.refills"));
+  EXPECT_LT(2, Instrument::get().count("fastio.allocations"));
+  EXPECT_EQ(1, Instrument::get().count("fastio.flushes"));
+  EXPECT_EQ(3, Instrument::get().count("fastio.bytes_written"));
+  EXPECT_EQ("42\n", StringIO::output);
+}
@@ -0,0 +1,478 @@
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "io.h"
+#include "bigint.h"
+
+// Serves a string in memory through the mapping interface, so only the
+// parser is measured.
+struct MemoryInput : public Stdio {
+  static std::string data;
+  bool map(const char*& input, size_t& size) {
+    input = data.c_str();
+    size = data.size() - 64;
+    return true;
+  }
+};
+
+std::string MemoryInput::data;
+
+void make_input(int n, long long range) {
+  MemoryInput::data.clear();
+  unsigned long long seed = 12345;
+  for (int i = 0; i < n; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    MemoryInput::data += std::to_string((seed >> 1) % range);
+    MemoryInput::data += i % 10 == 9 ? '\n' : ' ';
+  }
+  MemoryInput::data += std::string(64, '\0');
+}
+
+// The byte-at-a-time loop _fastio used before.
+template<typename T>
+void scalar_read(const char*& p, T& input) {
+  while (*p <= 32) p++;
+  input = *p++ - '0';
+  while (*p > 32) {
+    input = input * 10 + *p++ - '0';
+  }
+}
+
+BENCH(ScalarInt, 1000000) {
+  make_input(state.arg(), 1000000000);
+  std::vector<int> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    const char* p = MemoryInput::data.c_str();
+    for (int i = 0; i < state.arg(); i++) {
+      scalar_read(p, out[i]);
+    }
+    do_not_optimize(out);
+  }
+}
+
+// The same _fastio, one value per operator>>, which keeps the byte loop.
+BENCH(FastioLoopInt, 1000000) {
+  make_input(state.arg(), 1000000000);
+  std::vector<int> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    _fastio<8192, 20, MemoryInput> io;
+    for (int i = 0; i < state.arg(); i++) {
+      io >> out[i];
+    }
+    do_not_optimize(out);
+  }
+}
+
+BENCH(FastioInt, 1000000) {
+  make_input(state.arg(), 1000000000);
+  std::vector<int> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    _fastio<8192, 20, MemoryInput> io;
+    io.read_n(&out[0], out.size());
+    do_not_optimize(out);
+  }
+}
+
+// Three-digit values: the per-token cost dominates, not the digits.
+BENCH(FastioLoopShortInt, 1000000) {
+  make_input(state.arg(), 1000);
+  std::vector<int> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    _fastio<8192, 20, MemoryInput> io;
+    for (int i = 0; i < state.arg(); i++) {
+      io >> out[i];
+    }
+    do_not_optimize(out);
+  }
+}
+
+BENCH(FastioShortInt, 1000000) {
+  make_input(state.arg(), 1000);
+  std::vector<int> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    _fastio<8192, 20, MemoryInput> io;
+    io.read_n(&out[0], out.size());
+    do_not_optimize(out);
+  }
+}
+
+BENCH(ScalarLongLong, 1000000) {
+  make_input(state.arg(), 1000000000000000000LL);
+  std::vector<long long> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    const char* p = MemoryInput::data.c_str();
+    for (int i = 0; i < state.arg(); i++) {
+      scalar_read(p, out[i]);
+    }
+    do_not_optimize(out);
+  }
+}
+
+// The same _fastio, one value per operator>>, which keeps the byte loop.
+BENCH(FastioLoopLongLong, 1000000) {
+  make_input(state.arg(), 1000000000000000000LL);
+  std::vector<long long> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    _fastio<8192, 20, MemoryInput> io;
+    for (int i = 0; i < state.arg(); i++) {
+      io >> out[i];
+    }
+    do_not_optimize(out);
+  }
+}
+
+BENCH(FastioLongLong, 1000000) {
+  make_input(state.arg(), 1000000000000000000LL);
+  std::vector<long long> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    _fastio<8192, 20, MemoryInput> io;
+    io.read_n(&out[0], out.size());
+    do_not_optimize(out);
+  }
+}
+
+// Discards the output, so only the formatting is measured.
+struct NullOutput : public MemoryInput {
+  void write(char* output_buffer, int size) {
+    do_not_optimize(output_buffer[0]);
+  }
+};
+
+// The digit-at-a-time writer _fastio used before.
+template<typename T>
+void scalar_write(char*& q, T input) {
+  static char out[std::numeric_limits<T>::digits10 + 2];
+  out[0] = 0;
+  char *r = out + 1;
+  do {
+    *r++ = input % 10 + '0';
+    input /= 10;
+  } while (input);
+  while (*--r) {
+    *q++ = *r;
+  }
+}
+
+template<typename T>
+void random_values(std::vector<T>& out, long long range) {
+  unsigned long long seed = 12345;
+  for (unsigned i = 0; i < out.size(); i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    out[i] = (seed >> 1) % range;
+  }
+}
+
+template<typename T>
+void bench_scalar_write(BenchState& state, long long range) {
+  std::vector<T> values(state.arg());
+  random_values(values, range);
+  std::vector<char> buffer(values.size() * 21);
+  while (state.run()) {
+    char* q = &buffer[0];
+    for (unsigned i = 0; i < values.size(); i++) {
+      scalar_write(q, values[i]);
+      *q++ = ' ';
+    }
+    state.set_bytes(q - &buffer[0]);
+    do_not_optimize(buffer);
+  }
+}
+
+template<typename T>
+void bench_fastio_write(BenchState& state, long long range) {
+  std::vector<T> values(state.arg());
+  random_values(values, range);
+  _fastio<8192, 22, NullOutput> io;
+  std::vector<char> buffer(values.size() * 21);
+  char* q = &buffer[0];
+  for (unsigned i = 0; i < values.size(); i++) {
+    scalar_write(q, values[i]);
+    *q++ = ' ';
+  }
+  state.set_bytes(q - &buffer[0]);
+  while (state.run()) {
+    io.write_n(&values[0], values.size());
+  }
+}
+
+BENCH(ScalarWriteInt, 1000000) {
+  bench_scalar_write<int>(state, 1000000000);
+}
+
+BENCH(FastioWriteInt, 1000000) {
+  bench_fastio_write<int>(state, 1000000000);
+}
+
+BENCH(ScalarWriteLongLong, 1000000) {
+  bench_scalar_write<long long>(state, 1000000000000000000LL);
+}
+
+BENCH(FastioWriteLongLong, 1000000) {
+  bench_fastio_write<long long>(state, 1000000000000000000LL);
+}
+
+void make_double_input(int n) {
+  MemoryInput::data.clear();
+  unsigned long long seed = 12345;
+  char text[32];
+  for (int i = 0; i < n; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    snprintf(text, sizeof(text), "%.3f ", (seed >> 20) % 100000000 / 1000.0);
+    MemoryInput::data += text;
+  }
+  MemoryInput::data += std::string(64, '\0');
+}
+
+BENCH(StrtodDouble, 1000000) {
+  make_double_input(state.arg());
+  std::vector<double> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    char* p = const_cast<char*>(MemoryInput::data.c_str());
+    for (int i = 0; i < state.arg(); i++) {
+      out[i] = strtod(p, &p);
+    }
+    do_not_optimize(out);
+  }
+}
+
+BENCH(FastioReadDouble, 1000000) {
+  make_double_input(state.arg());
+  std::vector<double> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    _fastio<8192, 20, MemoryInput> io;
+    io.read_n(&out[0], out.size());
+    do_not_optimize(out);
+  }
+}
+
+BENCH(PrintfDouble, 1000000) {
+  std::vector<double> values(state.arg());
+  random_values(values, 100000000);
+  for (unsigned i = 0; i < values.size(); i++) {
+    values[i] /= 1000;
+  }
+  std::vector<char> buffer(values.size() * 32);
+  while (state.run()) {
+    char* q = &buffer[0];
+    for (unsigned i = 0; i < values.size(); i++) {
+      q += sprintf(q, "%.17g ", values[i]);
+    }
+    do_not_optimize(buffer);
+  }
+}
+
+BENCH(FastioWriteDouble, 1000000) {
+  std::vector<double> values(state.arg());
+  random_values(values, 100000000);
+  for (unsigned i = 0; i < values.size(); i++) {
+    values[i] /= 1000;
+  }
+  _fastio<8192, 32, NullOutput> io;
+  while (state.run()) {
+    io.write_n(&values[0], values.size());
+  }
+}
+
+// Serves MemoryInput::data at about 1 GB/s, sleeping like a disk would.
+struct ThrottledInput {
+  ThrottledInput() : position(0) {}
+  int read(char* input_buffer, int size) {
+    size = std::min<long long>(size, MemoryInput::data.size() - 64 - position);
+    memcpy(input_buffer, MemoryInput::data.data() + position, size);
+    position += size;
+    std::this_thread::sleep_for(std::chrono::microseconds(size >> 10));
+    return size;
+  }
+  void write(char* output_buffer, int size) {
+  }
+  long long position;
+};
+
+template<class CustomIO>
+void bench_throttled(BenchState& state) {
+  make_input(state.arg(), 1000000000);
+  std::vector<int> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    _fastio<1 << 16, 20, CustomIO> io;
+    io.read_n(&out[0], out.size());
+    do_not_optimize(out);
+  }
+}
+
+BENCH(SyncThrottledInt, 1000000) {
+  bench_throttled<ThrottledInput>(state);
+}
+
+BENCH(AsyncThrottledInt, 1000000) {
+  bench_throttled<AsyncIO<ThrottledInput> >(state);
+}
+
+template<int THREADS>
+void bench_parallel(BenchState& state) {
+  make_input(state.arg(), 1000000000);
+  std::string path = "/tmp/io_bench_parallel";
+  FILE* f = fopen(path.c_str(), "wb");
+  fwrite(MemoryInput::data.data(), 1, MemoryInput::data.size() - 64, f);
+  fclose(f);
+  state.set_bytes(MemoryInput::data.size() - 64);
+  std::vector<int> out;
+  while (state.run()) {
+    parallel_read(path.c_str(), THREADS, out);
+    do_not_optimize(out);
+  }
+  unlink(path.c_str());
+}
+
+BENCH(ParallelRead1, 4000000) {
+  bench_parallel<1>(state);
+}
+
+BENCH(ParallelRead4, 4000000) {
+  bench_parallel<4>(state);
+}
+
+void make_bigint_input(int n, int digits) {
+  MemoryInput::data.clear();
+  unsigned long long seed = 12345;
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < digits; j++) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      MemoryInput::data += char('1' + (seed >> 33) % 9);
+    }
+    MemoryInput::data += '\n';
+  }
+  MemoryInput::data += std::string(64, '\0');
+}
+
+BENCH(WordBigintRead, 1000) {
+  make_bigint_input(state.arg(), 1000);
+  std::vector<bigint> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  std::string word;
+  while (state.run()) {
+    _fastio<8192, 20, MemoryInput> io;
+    for (int i = 0; i < state.arg(); i++) {
+      io.word(word);
+      out[i] = bigint(word);
+    }
+    do_not_optimize(out);
+  }
+}
+
+BENCH(FastioBigintRead, 1000) {
+  make_bigint_input(state.arg(), 1000);
+  std::vector<bigint> out(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    _fastio<8192, 20, MemoryInput> io;
+    for (int i = 0; i < state.arg(); i++) {
+      io >> out[i];
+    }
+    do_not_optimize(out);
+  }
+}
+
+BENCH(StringBigintWrite, 1000) {
+  make_bigint_input(state.arg(), 1000);
+  std::vector<bigint> values(state.arg());
+  {
+    _fastio<8192, 20, MemoryInput> io;
+    for (int i = 0; i < state.arg(); i++) {
+      io >> values[i];
+    }
+  }
+  state.set_bytes(MemoryInput::data.size() - 64);
+  _fastio<8192, 20, NullOutput> io;
+  while (state.run()) {
+    for (int i = 0; i < state.arg(); i++) {
+      io << std::string(values[i]) << "\n";
+    }
+  }
+}
+
+BENCH(FastioBigintWrite, 1000) {
+  make_bigint_input(state.arg(), 1000);
+  std::vector<bigint> values(state.arg());
+  {
+    _fastio<8192, 20, MemoryInput> io;
+    for (int i = 0; i < state.arg(); i++) {
+      io >> values[i];
+    }
+  }
+  state.set_bytes(MemoryInput::data.size() - 64);
+  _fastio<8192, 20, NullOutput> io;
+  while (state.run()) {
+    for (int i = 0; i < state.arg(); i++) {
+      io << values[i] << "\n";
+    }
+  }
+}
+
+void make_text_input(int lines) {
+  MemoryInput::data.clear();
+  unsigned long long seed = 12345;
+  for (int i = 0; i < lines; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    int length = 20 + (seed >> 33) % 200;
+    for (int j = 0; j < length; j++) {
+      MemoryInput::data += j % 8 == 7 ? ' ' : char('a' + (j * 7 + i) % 26);
+    }
+    MemoryInput::data += '\n';
+  }
+  MemoryInput::data += std::string(64, '\0');
+}
+
+// The char-by-char line reader _fastio used before.
+void push_back_line(const char*& p, std::string& input) {
+  input.clear();
+  while (*p != 13 && *p != 10 && *p) {
+    input.push_back(*p++);
+  }
+  if (*p == 13 && *(p + 1) == 10) {
+    p++;
+  }
+  p++;
+}
+
+BENCH(PushBackLines, 100000) {
+  make_text_input(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    const char* p = MemoryInput::data.c_str();
+    size_t total = 0;
+    for (int i = 0; i < state.arg(); i++) {
+      std::string line;
+      push_back_line(p, line);
+      total += line.size();
+    }
+    do_not_optimize(total);
+  }
+}
+
+BENCH(FastioLines, 100000) {
+  make_text_input(state.arg());
+  state.set_bytes(MemoryInput::data.size() - 64);
+  while (state.run()) {
+    _fastio<8192, 20, MemoryInput> io;
+    size_t total = 0;
+    for (const Slice& line : io.lines()) {
+      total += line.size;
+    }
+    do_not_optimize(total);
+  }
+}
@@ -1,7 +1,11 @@
 #include <string>
 #include <cstring>
+#include <clocale>
+#include <stdexcept>
 #include "gtest/gtest.h"
 #include "io.h"
+#include "bigint.h"
+#include "modint.h"
 
 using namespace std;
 
@@ -16,7 +20,7 @@ class MemoryStdio {
 
   int read(char* input_buffer, int size) {
     string sub = input_.substr(pos_, size);
-    strcpy(input_buffer, sub.c_str());
+    memcpy(input_buffer, sub.data(), sub.size());
     pos_ += sub.size();
     return sub.size();
   }
@@ -124,6 +128,42 @@ TEST_IO(ReadLineWindows, 200, 30, "ricbit ilafox\r\nvinil") {
   EXPECT_EQ(string("vinil"), input);
 }
 
+#define LONG_WORD "abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz"
+
+TEST_IO(ReadLongWords, 32, 20, "x " LONG_WORD " " LONG_WORD LONG_WORD "\n y") {
+  fastio_ReadLongWords io;
+  EXPECT_TRUE(io.word() == "x");
+  EXPECT_TRUE(io.word() == LONG_WORD);
+  string input;
+  io.word(input);
+  EXPECT_EQ(string(LONG_WORD LONG_WORD), input);
+  EXPECT_TRUE(io.word() == "y");
+  EXPECT_TRUE(io.word().empty());
+}
+
+TEST_IO(ReadLines, 32, 20, "first line\r\n\n" LONG_WORD " " LONG_WORD
+        "\r\nmac\rpadding padding pad\r\nlast") {
+  fastio_ReadLines io;
+  const char* expected[] = {"first line", "", LONG_WORD " " LONG_WORD, "mac",
+                            "padding padding pad", "last"};
+  int count = 0;
+  for (const Slice& line : io.lines()) {
+    ASSERT_LT(count, 6);
+    EXPECT_EQ(string(expected[count]), string(line));
+    count++;
+  }
+  EXPECT_EQ(6, count);
+}
+
+TEST_IO(ReadLinesTrailingNewline, 200, 30, "a b\n\nc\n") {
+  fastio_ReadLinesTrailingNewline io;
+  vector<string> lines;
+  for (const Slice& line : io.lines()) {
+    lines.push_back(line);
+  }
+  EXPECT_EQ(vector<string>({"a b", "", "c"}), lines);
+}
+
 TEST_IO(WriteInt, 200, 30, "") {
   {
     fastio_WriteInt io;
@@ -141,6 +181,44 @@ TEST_IO(WriteInt, 200, 30, "") {
             out_WriteInt::get());
 }
 
+TEST_IO(WriteAllLengths, 64, 24, "") {
+  string expected;
+  {
+    fastio_WriteAllLengths io;
+    unsigned long long power = 1;
+    for (int i = 0; i < 20; i++, power *= 10) {
+      io << power - 1 << " " << power << " ";
+      expected += to_string(power - 1) + " " + to_string(power) + " ";
+    }
+    io << 0 << " " << -10 << " " << -99;
+    expected += "0 -10 -99";
+  }
+  EXPECT_EQ(expected, out_WriteAllLengths::get());
+}
+
+TEST_IO(WriteLeadingZeros, 200, 30, "") {
+  {
+    fastio_WriteLeadingZeros io;
+    io.write_absolute_leading_zeros(42, 5);
+    io << " ";
+    io.write_absolute_leading_zeros(123456789, 9);
+    io << " ";
+    io.write_absolute_leading_zeros(7, 1);
+  }
+  EXPECT_EQ(string("00042 123456789 7"), out_WriteLeadingZeros::get());
+}
+
+TEST_IO(WriteN, 32, 22, "") {
+  long long values[] = {0, -1, 12, std::numeric_limits<long long>::min(),
+                        std::numeric_limits<long long>::max(), 100};
+  {
+    fastio_WriteN io;
+    io.write_n(values, 6).write_n(values, 3, '\n');
+  }
+  EXPECT_EQ(string("0 -1 12 -9223372036854775808 9223372036854775807 100"
+                   "0\n-1\n12"), out_WriteN::get());
+}
+
 TEST_IO(WriteString, 200, 30, "") {
   {
     fastio_WriteString io;
@@ -151,4 +229,519 @@ TEST_IO(WriteString, 200, 30, "") {
   EXPECT_EQ(string("ricbit ilafox\n"), out_WriteString::get());
 }
 
+void redirect_stdin(const string& contents, bool pipe_input) {
+  if (pipe_input) {
+    int fd[2];
+    ASSERT_EQ(0, pipe(fd));
+    ASSERT_EQ(ssize_t(contents.size()),
+              ::write(fd[1], contents.data(), contents.size()));
+    close(fd[1]);
+    dup2(fd[0], 0);
+    close(fd[0]);
+  } else {
+    char path[] = "/tmp/io_testXXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ssize_t(contents.size()),
+              ::write(fd, contents.data(), contents.size()));
+    lseek(fd, 0, SEEK_SET);
+    dup2(fd, 0);
+    close(fd);
+    unlink(path);
+  }
+  clearerr(stdin);
+}
+
+void check_mmap_input(bool pipe_input) {
+  string contents;
+  for (int i = 0; i < 5000; i++) {
+    contents += to_string(i * 7919 - 20000) + (i % 7 ? " " : "\n");
+  }
+  contents += "last word";
+  redirect_stdin(contents, pipe_input);
+  _fastio<64, 20, MmapStdio> io;
+  for (int i = 0; i < 5000; i++) {
+    EXPECT_EQ(i * 7919 - 20000, static_cast<int>(io));
+  }
+  string input;
+  io.word(input);
+  EXPECT_EQ(string("last"), input);
+  io.word(input);
+  EXPECT_EQ(string("word"), input);
+}
+
+TEST(IoTest, MmapRegularFile) {
+  check_mmap_input(false);
+}
+
+TEST(IoTest, MmapPipeFallback) {
+  check_mmap_input(true);
+}
+
+TEST(IoTest, MappedFileEmpty) {
+  char path[] = "/tmp/io_testXXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  MappedFile file;
+  EXPECT_TRUE(file.open(path));
+  EXPECT_EQ(0U, file.size());
+  EXPECT_EQ(0, file.data()[0]);
+  unlink(path);
+}
+
+TEST_IO(ReadIntAllLengths, 64, 24, "0 1 12 123 1234 12345 123456 1234567 "
+    "12345678 123456789 1234567890 12345678901 123456789012 "
+    "1234567890123 12345678901234 123456789012345 1234567890123456 "
+    "12345678901234567 123456789012345678 -1234567890123456789 "
+    "                                           9") {
+  fastio_ReadIntAllLengths io;
+  long long expected = 0;
+  EXPECT_EQ(0LL, static_cast<long long>(io));
+  for (int i = 1; i <= 18; i++) {
+    expected = expected * 10 + i % 10;
+    EXPECT_EQ(expected, static_cast<long long>(io));
+  }
+  EXPECT_EQ(-1234567890123456789LL, static_cast<long long>(io));
+  EXPECT_EQ(9, static_cast<int>(io));
+}
+
+TEST_IO(ReadN, 32, 20, "5 -4 3 -2 1 0 7 8\n9 10") {
+  fastio_ReadN io;
+  int values[10];
+  io.read_n(values, 10);
+  int ans[] = {5, -4, 3, -2, 1, 0, 7, 8, 9, 10};
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(ans[i], values[i]);
+}
+
+TEST_IO(ReadNBuffered, 64, 24, "1 -22 333 -4444 55555 -666666 7777777 "
+    "-88888888 999999999 -1234567890123456789 18 -17 16\n\n\n"
+    "                                                          "
+    "15 -14 13 -12 11 -10 9") {
+  fastio_ReadNBuffered io;
+  long long values[20];
+  io.read_n(values, 20);
+  long long ans[] = {1, -22, 333, -4444, 55555, -666666, 7777777, -88888888,
+                     999999999, -1234567890123456789LL, 18, -17, 16, 15, -14,
+                     13, -12, 11, -10, 9};
+  for (int i = 0; i < 20; i++)
+    EXPECT_EQ(ans[i], values[i]);
+}
+
+TEST_IO(ReadNAllLengths, 48, 24, "1 12 123 1234 12345 123456 1234567 "
+    "12345678 123456789 1234567890 12345678901 123456789012 "
+    "1234567890123 12345678901234 123456789012345 1234567890123456 "
+    "12345678901234567 123456789012345678 1234567890123456789 "
+    "12345678901234567890") {
+  fastio_ReadNAllLengths io;
+  unsigned long long values[20], expected = 0;
+  io.read_n(values, 20);
+  for (int i = 0; i < 20; i++) {
+    expected = expected * 10 + (i + 1) % 10;
+    EXPECT_EQ(expected, values[i]);
+  }
+}
+
+TEST_IO(ReadDouble, 64, 40, "1 -2.5 0.1 3.14159 1e10 -1.5E-3 .5 7. "
+    "123456789012345678901234567890 1e300 4.9e-324 inf -nan "
+    "0.30000000000000004 -0 2.2250738585072014e-308") {
+  fastio_ReadDouble io;
+  const char* expected[] = {"1", "-2.5", "0.1", "3.14159", "1e10", "-1.5E-3",
+      ".5", "7.", "123456789012345678901234567890", "1e300", "4.9e-324",
+      "inf", "-nan", "0.30000000000000004", "-0", "2.2250738585072014e-308"};
+  for (int i = 0; i < 16; i++) {
+    double value = io;
+    double reference = strtod(expected[i], NULL);
+    if (std::isnan(reference)) {
+      EXPECT_TRUE(std::isnan(value));
+    } else {
+      EXPECT_EQ(reference, value) << expected[i];
+      EXPECT_EQ(std::signbit(reference), std::signbit(value));
+    }
+  }
+}
+
+TEST_IO(ReadFloat, 64, 30, "0.1 16777217 3.4028235e38") {
+  fastio_ReadFloat io;
+  float a, b, c;
+  io >> a >> b >> c;
+  EXPECT_EQ(strtof("0.1", NULL), a);
+  EXPECT_EQ(strtof("16777217", NULL), b);
+  EXPECT_EQ(strtof("3.4028235e38", NULL), c);
+}
+
+TEST_IO(WriteDouble, 64, 30, "") {
+  {
+    fastio_WriteDouble io;
+    io << 0.0 << " " << -0.0 << " " << 1.0 << " " << -2.5 << " " << 0.1
+       << " " << 1.0 / 3 << " " << 0.1 + 0.2 << " " << 1e100 << " "
+       << 1.5e-7 << " " << 0.0001 << " " << 123456.0 << " " << 1e17 << " "
+       << 5e-324 << " " << std::numeric_limits<double>::max() << " "
+       << 0.1f << " " << 1.0 / 0.0 << " " << -1.0 / 0.0;
+  }
+  EXPECT_EQ(string("0 -0 1 -2.5 0.1 0.3333333333333333 0.30000000000000004 "
+                   "1e+100 1.5e-07 0.0001 123456 1e+17 5e-324 "
+                   "1.7976931348623157e+308 0.1 inf -inf"),
+            out_WriteDouble::get());
+}
+
+TEST_IO(WriteFixed, 64, 30, "") {
+  {
+    fastio_WriteFixed io;
+    io.precision(2) << 0.125 << " " << 0.375 << " " << 1.005 << " "
+                    << -0.001 << " " << 2.0 << " " << 1e20;
+    io.precision(0) << " " << 2.5 << " " << 3.5;
+    io.precision(-1) << " " << 0.25;
+  }
+  EXPECT_EQ(string("0.12 0.38 1.00 -0.00 2.00 100000000000000000000.00 "
+                   "2 4 0.25"), out_WriteFixed::get());
+}
+
+// Every value must read back exactly, with no more significant digits
+// than the shortest %e form that does.
+TEST_IO(WriteDoubleRoundTrip, 256, 40, "") {
+  vector<double> values;
+  unsigned long long seed = 1;
+  for (int i = 0; i < 3000; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    double value;
+    memcpy(&value, &seed, sizeof(value));
+    if (!std::isnan(value) && !std::isinf(value)) {
+      values.push_back(value);
+    }
+    values.push_back(static_cast<double>(seed % 1000000) / 1000);
+  }
+  {
+    fastio_WriteDoubleRoundTrip io;
+    io.write_n(&values[0], values.size());
+  }
+  const char* s = out_WriteDoubleRoundTrip::get().c_str();
+  for (unsigned i = 0; i < values.size(); i++) {
+    char* end;
+    EXPECT_EQ(values[i], strtod(s, &end));
+    string digits;
+    for (; s < end && *s != 'e'; s++) {
+      if (isdigit(*s) && (*s != '0' || !digits.empty())) {
+        digits += *s;
+      }
+    }
+    digits.erase(digits.find_last_not_of('0') + 1);
+    int shortest = 1;
+    char text[32];
+    while (true) {
+      snprintf(text, sizeof(text), "%.*e", shortest - 1, values[i]);
+      if (strtod(text, NULL) == values[i]) break;
+      shortest++;
+    }
+    EXPECT_LE(int(digits.size()), shortest) << values[i];
+    s = end + 1;
+  }
+}
+
+// Input and output in strings that tests can fill at runtime.
+struct StringStdio {
+  static string input, output;
+  static int pos;
+
+  int read(char* buffer, int size) {
+    int length = min<int>(size, input.size() - pos);
+    memcpy(buffer, input.data() + pos, length);
+    pos += length;
+    return length;
+  }
+
+  void write(char* buffer, int size) {
+    output.append(buffer, size);
+  }
+};
+
+string StringStdio::input, StringStdio::output;
+int StringStdio::pos = 0;
+
+// Powers of two whose shortest form is not the correctly rounded one: the
+// next 16-digit decimal up reads back, the rounded one does not.
+TEST_IO(WriteDoublePowerOfTwo, 256, 40, "") {
+  {
+    fastio_WriteDoublePowerOfTwo io;
+    io << ldexp(1.0, -1017) << " " << ldexp(1.0, -957) << " "
+       << ldexp(1.0, -808) << " " << ldexp(1.0, 10);
+  }
+  EXPECT_EQ(string("7.120236347223045e-307 8.209073602596753e-289 "
+                   "5.858190679279809e-244 1024"),
+            out_WriteDoublePowerOfTwo::get());
+}
+
+TEST(IoTest, FloatsIgnoreLocale) {
+  if (setlocale(LC_NUMERIC, "de_DE.UTF-8") == NULL &&
+      setlocale(LC_NUMERIC, "fr_FR.UTF-8") == NULL) {
+    GTEST_SKIP() << "no locale with a comma decimal point";
+  }
+  StringStdio::input = "0.1 1.5e-320 2.5";
+  StringStdio::pos = 0;
+  StringStdio::output.clear();
+  {
+    _fastio<64, 20, StringStdio> io;
+    double a = io, b = io, c = io;
+    io << a << " " << b << " " << 0.1 + 0.2 << " ";
+    io.precision(30) << c;
+  }
+  setlocale(LC_NUMERIC, "C");
+  EXPECT_EQ(string("0.1 1.5e-320 0.30000000000000004 "
+                   "2.500000000000000000000000000000"), StringStdio::output);
+}
+
+// Shortest forms can be longer than STRMAX, so with the default buffer
+// some of them cross a refill.
+TEST(IoTest, ReadDoubleAcrossRefill) {
+  vector<double> values;
+  for (int i = 0; i < 5000; i++) {
+    values.push_back(i % 2 ? -2.2250738585072014e-308 : 1.0 / (i + 3));
+  }
+  StringStdio::output.clear();
+  {
+    _fastio<8192, 20, StringStdio> io;
+    io.write_n(&values[0], values.size());
+  }
+  StringStdio::input = StringStdio::output + " 42";
+  StringStdio::pos = 0;
+  _fastio<8192, 20, StringStdio> io;
+  vector<double> read(values.size());
+  io.read_n(&read[0], read.size());
+  for (unsigned i = 0; i < values.size(); i++) {
+    ASSERT_EQ(values[i], read[i]) << i;
+  }
+  EXPECT_EQ(42, int(io));
+
+  // Single zeros up to 10 bytes before the end of the first read, then a
+  // 24-byte token.
+  StringStdio::input = "";
+  for (int i = 0; i < (8192 - 10) / 2; i++) {
+    StringStdio::input += "0 ";
+  }
+  StringStdio::input += "-2.2250738585072014e-308 7";
+  StringStdio::pos = 0;
+  _fastio<8192, 20, StringStdio> edge;
+  for (int i = 0; i < (8192 - 10) / 2; i++) {
+    ASSERT_EQ(0.0, double(edge));
+  }
+  EXPECT_EQ(-2.2250738585072014e-308, double(edge));
+  EXPECT_EQ(7, int(edge));
+}
+
+extern const char input_AsyncIO[] = "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 "
+    "17 18 19 20 21 22 23 24 25 26 27 28 29 30";
+typedef MemoryStdio<input_AsyncIO> out_AsyncIO;
+
+TEST(IoTest, AsyncIO) {
+  {
+    _fastio<32, 20, AsyncIO<out_AsyncIO, 16, 2> > io;
+    for (int i = 1; i <= 30; i++) {
+      int value = io;
+      EXPECT_EQ(i, value);
+      io << value * 1000 << " ";
+    }
+  }
+  string expected;
+  for (int i = 1; i <= 30; i++) {
+    expected += to_string(i * 1000) + " ";
+  }
+  EXPECT_EQ(expected, out_AsyncIO::get());
+}
+
+// An endless, slow input that counts the reads made on it.
+struct CountingInput : public Stdio {
+  static atomic<int> reads;
+  int read(char* buffer, int size) {
+    this_thread::sleep_for(chrono::milliseconds(2));
+    memset(buffer, '1', size);
+    buffer[size - 1] = ' ';
+    reads++;
+    return size;
+  }
+};
+
+atomic<int> CountingInput::reads(0);
+
+// The ring has room for eight blocks, but after the AsyncIO is destroyed
+// only a read already in flight may finish.
+TEST(IoTest, AsyncStopsReading) {
+  {
+    AsyncIO<CountingInput, 16, 8> io;
+    char buffer[32];
+    EXPECT_EQ(32, io.read(buffer, 32));
+  }
+  int reads = CountingInput::reads;
+  this_thread::sleep_for(chrono::milliseconds(50));
+  EXPECT_LE(CountingInput::reads, reads + 1);
+}
 
+TEST(IoTest, AsyncStdin) {
+  string contents;
+  long long expected = 0;
+  for (int i = 0; i < 100000; i++) {
+    contents += to_string(i * 7919LL) + (i % 10 == 9 ? "\n" : " ");
+    expected += i * 7919LL;
+  }
+  redirect_stdin(contents, false);
+  _fastio<1024, 20, AsyncIO<Stdio, 4096, 3> > io;
+  vector<long long> values(100000);
+  io.read_n(&values[0], values.size());
+  long long sum = 0;
+  for (unsigned i = 0; i < values.size(); i++) {
+    sum += values[i];
+  }
+  EXPECT_EQ(expected, sum);
+}
+
+string temp_file(const string& contents) {
+  char path[] = "/tmp/io_testXXXXXX";
+  int fd = mkstemp(path);
+  EXPECT_EQ(ssize_t(contents.size()),
+            ::write(fd, contents.data(), contents.size()));
+  close(fd);
+  return path;
+}
+
+TEST(IoTest, ParallelRead) {
+  string contents;
+  vector<long long> expected;
+  for (int i = 0; i < 200000; i++) {
+    expected.push_back((i * 2654435761LL) % 1000000007 - 500000000);
+    contents += to_string(expected.back());
+    contents += i % 7 == 6 ? "\n" : " ";
+  }
+  contents.pop_back();
+  string path = temp_file(contents);
+  for (int threads = 1; threads <= 8; threads *= 2) {
+    vector<long long> values;
+    EXPECT_TRUE(parallel_read(path.c_str(), threads, values));
+    EXPECT_EQ(expected, values);
+  }
+  unlink(path.c_str());
+}
+
+TEST(IoTest, ParallelReadCallbackOrder) {
+  string contents;
+  for (int i = 0; i < 300000; i++) {
+    contents += to_string(i) + " ";
+  }
+  string path = temp_file(contents);
+  int expected_chunk = 0;
+  unsigned next = 0;
+  EXPECT_TRUE(parallel_read<unsigned>(path.c_str(), 4,
+      [&](int chunk, const vector<unsigned>& values) {
+        EXPECT_EQ(expected_chunk++, chunk);
+        for (unsigned i = 0; i < values.size(); i++) {
+          EXPECT_EQ(next++, values[i]);
+        }
+      }));
+  EXPECT_EQ(300000U, next);
+  EXPECT_GT(expected_chunk, 1);
+  unlink(path.c_str());
+}
+
+TEST(IoTest, ParallelReadEdges) {
+  string path = temp_file("");
+  vector<double> values;
+  EXPECT_TRUE(parallel_read(path.c_str(), 4, values));
+  EXPECT_TRUE(values.empty());
+  unlink(path.c_str());
+  path = temp_file("  1.5\n-2.25   ");
+  EXPECT_TRUE(parallel_read(path.c_str(), 4, values));
+  EXPECT_EQ(vector<double>({1.5, -2.25}), values);
+  unlink(path.c_str());
+  EXPECT_FALSE(parallel_read("/nonexistent/io_test", 4, values));
+}
+
+TEST(IoTest, ParallelReadCallbackThrows) {
+  string contents;
+  for (int i = 0; i < 200000; i++) {
+    contents += to_string(i) + "\n";
+  }
+  string path = temp_file(contents);
+  int calls = 0;
+  EXPECT_THROW(parallel_read<int>(path.c_str(), 4,
+      [&calls](int chunk, const vector<int>& values) {
+        if (++calls == 2) {
+          throw runtime_error("stop");
+        }
+      }), runtime_error);
+  EXPECT_EQ(2, calls);
+  unlink(path.c_str());
+}
+
+TEST_IO(ReadSome, 32, 20, "1 2 3\n4 5  ") {
+  fastio_ReadSome io;
+  int values[10];
+  EXPECT_EQ(3U, io.read_some(values, 3));
+  EXPECT_FALSE(io.eof());
+  EXPECT_EQ(2U, io.read_some(values + 3, 7));
+  EXPECT_TRUE(io.eof());
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(i + 1, values[i]);
+  }
+}
+
+TEST_IO(ReadBigint, 32, 20, "0 7 123456789 1234567890 "
+    "000000000000000000042 "
+    "98765432109876543210987654321098765432109876543210 5") {
+  fastio_ReadBigint io;
+  const char* expected[] = {"0", "7", "123456789", "1234567890", "42",
+      "98765432109876543210987654321098765432109876543210"};
+  for (int i = 0; i < 6; i++) {
+    bigint value;
+    io >> value;
+    if (i == 0) {
+      EXPECT_EQ(0, value.size());
+    } else {
+      EXPECT_EQ(string(expected[i]), string(value));
+    }
+  }
+  _bigint<4> small = io;
+  EXPECT_EQ(string("5"), string(small));
+}
+
+TEST_IO(WriteBigint, 32, 20, "") {
+  {
+    fastio_WriteBigint io;
+    io << bigint(0) << " " << bigint("0") << " " << bigint(1000000000) << " "
+       << bigint("98765432109876543210000000000000000000000000000001") << " "
+       << _bigint<4>("100020003") << " " << bigint(7).power(50);
+  }
+  EXPECT_EQ(string("0 0 1000000000 "
+                   "98765432109876543210000000000000000000000000000001 "
+                   "100020003 ") + string(bigint(7).power(50)),
+            out_WriteBigint::get());
+}
+
+TEST_IO(ModintIO, 32, 20, "5 -3 1000000007 123456789012345678901234567890") {
+  typedef modint<1000000007> mint;
+  {
+    fastio_ModintIO io;
+    mint a, b, c, d;
+    io >> a >> b >> c >> d;
+    EXPECT_EQ(5, int(a));
+    EXPECT_EQ(1000000004, int(b));
+    EXPECT_EQ(0, int(c));
+    mint expected(0);
+    string digits = "123456789012345678901234567890";
+    for (unsigned i = 0; i < digits.size(); i++) {
+      expected = expected * mint(10) + mint(digits[i] - '0');
+    }
+    EXPECT_EQ(int(expected), int(d));
+    io << a << " " << b << " " << d;
+  }
+  EXPECT_EQ(string("5 1000000004 ") + to_string(int(
+      bigint("123456789012345678901234567890") % 1000000007)),
+      out_ModintIO::get());
+}
+
+TEST_IO(WriteLongString, 32, 20, "") {
+  string text(1000, 'x');
+  {
+    fastio_WriteLongString io;
+    io << text << "\n";
+  }
+  EXPECT_EQ(text + "\n", out_WriteLongString::get());
+}
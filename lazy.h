@@ -18,6 +18,7 @@
 #include <tr1/unordered_map>
 #include <tr1/unordered_set>
 #include <tr1/tuple>
+#include "hashmap.h"
 
 //reserve pii llint uint
 
@@ -29,6 +30,6 @@ typedef pair<int,int> pii;
 typedef long long int llint;
 typedef unsigned int uint;
 
-#define hash_map unordered_map
-#define hash_set unordered_set
+#define hash_map flat_hash_map
+#define hash_set flat_hash_set
 
@@ -1,20 +1,28 @@
 #include <vector>
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <memory>
+#include <stdint.h>
+#include <type_traits>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "instrument.h"
 
-//reserve matrix rows cols id determinant inverse
+//reserve matrix gf2matrix rows cols id determinant inverse rank solve nullspace set_strassen apply_power charpoly
 
 template<typename T>
 class matrix {
  public:
-  typedef std::vector<T> vt;
-  typedef std::vector<vt> vvt;
+  typedef std::vector<T, INSTRUMENT_ALLOCATOR(T, Matrix)> vt;
+  typedef std::vector<vt, INSTRUMENT_ALLOCATOR(vt, Matrix)> vvt;
 
   matrix(int rows, int cols)
       : mat_(rows, vt(cols)),
         rows_(rows),
         cols_(cols),
+        strassen_(0),
         id_cache_(NULL) {
   }
 
@@ -23,6 +31,7 @@ class matrix {
       : mat_(rows, vt(cols)),
         rows_(rows),
         cols_(cols),
+        strassen_(0),
         id_cache_(NULL) {
     for (int j = 0; j < rows; j++) {
       for (int i = 0; i < cols; i++) {
@@ -32,6 +41,24 @@ class matrix {
     }
   }
 
+  // The identity cache is never shared, so each copy frees only its own.
+  matrix(const matrix<T>& b)
+      : mat_(b.mat_), rows_(b.rows_), cols_(b.cols_), strassen_(b.strassen_),
+        id_cache_(NULL) {
+  }
+
+  matrix<T>& operator=(const matrix<T>& b) {
+    if (this != &b) {
+      mat_ = b.mat_;
+      rows_ = b.rows_;
+      cols_ = b.cols_;
+      strassen_ = b.strassen_;
+      delete id_cache_;
+      id_cache_ = NULL;
+    }
+    return *this;
+  }
+
   virtual ~matrix() {
     if (id_cache_ != NULL) {
       delete id_cache_;
@@ -54,6 +81,15 @@ class matrix {
     return cols_;
   }
 
+  // Makes operator* and power() on this matrix use Strassen-Winograd,
+  // recursing until blocks are at most threshold wide; 0 turns it off.
+  // Needs exact arithmetic with subtraction, e.g. modint or long long
+  // without overflow; not bigint, which is unsigned, nor double. Blocks of
+  // 16 to 64 were fastest in matrix_bench for modint and long long.
+  void set_strassen(int threshold = 32) {
+    strassen_ = threshold;
+  }
+
   matrix<T> operator+(const matrix<T>& b) const {
     matrix<T> ans(rows_, cols_);
     for (int j = 0; j < rows_; j++) {
@@ -81,6 +117,7 @@ class matrix {
 
   template <typename S>
   matrix<T> power(S n) const {
+    INSTRUMENT_TIMER("matrix.power");
     if (n == 0) return id();
     if (n == 1) return *this;
 
@@ -98,6 +135,159 @@ class matrix {
     return ans;
   }
   
+  // A^k v by squaring A, still O(n^3 log k): only the products with the
+  // partial answer become matrix-vector products, which saves about half of
+  // power(k). Small k uses k matrix-vector products instead. For large k,
+  // the overload taking charpoly() avoids the squarings altogether.
+  template <typename S>
+  vt apply_power(S k, const vt& v) const {
+    return apply_power(k, std::vector<vt>(1, v))[0];
+  }
+
+  // A^k v for every v, sharing the squarings: O(n^3 log k) once, plus
+  // O(n^2 log k) per vector.
+  template <typename S>
+  std::vector<vt> apply_power(S k, const std::vector<vt>& vs) const {
+    INSTRUMENT_TIMER("matrix.apply_power");
+    std::vector<vt> ans(vs);
+    if (k <= S(rows_)) {
+      for (S i = 0; i < k; i++) {
+        for (unsigned j = 0; j < ans.size(); j++) {
+          ans[j] = apply(mat_, ans[j]);
+        }
+      }
+      return ans;
+    }
+    matrix<T> b(*this), temp(rows_, cols_);
+    for (S exp = k; exp; exp >>= 1) {
+      if (exp & 1) {
+        for (unsigned j = 0; j < ans.size(); j++) {
+          ans[j] = apply(b.mat_, ans[j]);
+        }
+      }
+      if (exp > 1) {
+        mul(b, b, temp);
+        b.mat_.swap(temp.mat_);
+      }
+    }
+    return ans;
+  }
+
+  // Same, given poly = charpoly(): x^k is reduced modulo poly in
+  // O(n^2 log k), and A^k v = r(A) v follows by Horner in n - 1
+  // matrix-vector products, with no n x n product at all. That is O(n^3)
+  // per vector whatever k is, and charpoly() itself is O(n^3) once.
+  template <typename S>
+  vt apply_power(S k, const vt& v, const vt& poly) const {
+    return apply_power(k, std::vector<vt>(1, v), poly)[0];
+  }
+
+  template <typename S>
+  std::vector<vt> apply_power(S k, const std::vector<vt>& vs,
+                              const vt& poly) const {
+    INSTRUMENT_TIMER("matrix.apply_power");
+    int n = rows_;
+    if (n == 0) {
+      return vs;
+    }
+    std::vector<bool> bits;
+    for (S exp = k; exp; exp >>= 1) {
+      bits.push_back(exp & 1);
+    }
+    vt r(n, T(0));
+    r[0] = T(1);
+    for (int b = int(bits.size()) - 1; b >= 0; b--) {
+      vt square(2 * n, T(0));
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+          square[i + j] = square[i + j] + r[i] * r[j];
+        }
+      }
+      if (bits[b]) {
+        square.insert(square.begin(), T(0));
+      }
+      for (int d = int(square.size()) - 1; d >= n; d--) {
+        T c = square[d];
+        for (int i = 0; i < n; i++) {
+          square[d - n + i] = square[d - n + i] - c * poly[i];
+        }
+      }
+      std::copy(square.begin(), square.begin() + n, r.begin());
+    }
+    std::vector<vt> ans(vs.size());
+    for (unsigned j = 0; j < vs.size(); j++) {
+      vt w(n);
+      for (int e = 0; e < n; e++) {
+        w[e] = r[n - 1] * vs[j][e];
+      }
+      for (int i = n - 2; i >= 0; i--) {
+        w = apply(mat_, w);
+        for (int e = 0; e < n; e++) {
+          w[e] = w[e] + r[i] * vs[j][e];
+        }
+      }
+      ans[j] = w;
+    }
+    return ans;
+  }
+
+  // Coefficients of det(xI - A), from x^0 up to the leading 1 at x^n.
+  // The matrix is brought to upper Hessenberg form by similarity, then the
+  // polynomials of its leading submatrices follow by recurrence, in O(n^3).
+  // T must be a field: modint with a prime modulus, or double, which takes
+  // the largest pivot in each column to keep the reduction stable.
+  vt charpoly() const {
+    int n = rows_;
+    vvt h(mat_);
+    for (int j = 0; j + 2 < n; j++) {
+      int pivot = j + 1;
+      for (int k = j + 2; k < n; k++) {
+        if (better_pivot(h[k][j], h[pivot][j],
+                         std::is_floating_point<T>())) {
+          pivot = k;
+        }
+      }
+      if (h[pivot][j] == T(0)) {
+        continue;
+      }
+      if (pivot != j + 1) {
+        h[pivot].swap(h[j + 1]);
+        for (int i = 0; i < n; i++) {
+          std::swap(h[i][pivot], h[i][j + 1]);
+        }
+      }
+      T inv = T(1) / h[j + 1][j];
+      for (int k = j + 2; k < n; k++) {
+        T f = h[k][j] * inv;
+        if (f == T(0)) continue;
+        for (int i = 0; i < n; i++) {
+          h[k][i] = h[k][i] - f * h[j + 1][i];
+        }
+        for (int i = 0; i < n; i++) {
+          h[i][j + 1] = h[i][j + 1] + f * h[i][k];
+        }
+      }
+    }
+    std::vector<vt> p(n + 1);
+    p[0] = vt(1, T(1));
+    for (int i = 0; i < n; i++) {
+      p[i + 1] = vt(i + 2, T(0));
+      for (int d = 0; d <= i; d++) {
+        p[i + 1][d + 1] = p[i][d];
+        p[i + 1][d] = p[i + 1][d] - h[i][i] * p[i][d];
+      }
+      T below = T(1);
+      for (int m = i - 1; m >= 0; m--) {
+        below = below * h[m + 1][m];
+        T c = h[m][i] * below;
+        for (int d = 0; d <= m; d++) {
+          p[i + 1][d] = p[i + 1][d] - c * p[m][d];
+        }
+      }
+    }
+    return p[n];
+  }
+
   bool operator==(const matrix<T>& b) const {
     for (int j = 0; j < rows_; j++) {
       if (!std::equal(mat_[j].begin(), mat_[j].end(), b[j].begin())) {
@@ -139,7 +329,7 @@ class matrix {
 
   std::pair<bool, matrix<T> > inverse() {
     int n = rows_;
-    std::vector<std::vector<T> > mat(n, std::vector<T>(2 * n, T(0)));
+    vvt mat(n, vt(2 * n, T(0)));
     for (int j = 0; j < rows_; j++) {
       for (int i = 0; i < cols_; i++) {
         mat[j][i] = mat_[j][i];
@@ -184,7 +374,23 @@ class matrix {
   }
 
  private:
+  // Largest magnitude for floating types, first nonzero otherwise.
+  static bool better_pivot(const T& a, const T& b, std::true_type) {
+    return std::abs(a) > std::abs(b);
+  }
+
+  static bool better_pivot(const T& a, const T& b, std::false_type) {
+    return b == T(0) && !(a == T(0));
+  }
+
   void mul(const matrix<T>& a, const matrix<T>& b, matrix<T>& ans) const {
+    if (strassen_ > 0 && std::max(std::max(a.rows(), a.cols()), b.cols()) >
+        strassen_) {
+      strassen(a, b, ans);
+      return;
+    }
+    INSTRUMENT_COUNT("matrix.multiply_adds",
+                     static_cast<long long>(a.rows()) * b.cols() * a.cols());
     for (int j = 0; j < a.rows(); j++) {
       for (int i = 0; i < b.cols(); i++) {
         ans[j][i] = 0;
@@ -195,7 +401,359 @@ class matrix {
     }
   }
  
+  static vt apply(const vvt& a, const vt& v) {
+    INSTRUMENT_COUNT("matrix.multiply_adds", a.size() * v.size());
+    vt ans(a.size(), T(0));
+    for (unsigned j = 0; j < a.size(); j++) {
+      for (unsigned i = 0; i < v.size(); i++) {
+        ans[j] = ans[j] + a[j][i] * v[i];
+      }
+    }
+    return ans;
+  }
+
+  // Pads the operands with zeros to n x n, n = base << levels with base at
+  // most the threshold, and copies them to flat arrays. One workspace holds
+  // them, the product and the temporaries of every recursion level.
+  void strassen(const matrix<T>& a, const matrix<T>& b, matrix<T>& ans) const {
+    int base = std::max(std::max(a.rows(), a.cols()), b.cols()), levels = 0;
+    while (base > strassen_) {
+      base = (base + 1) / 2;
+      levels++;
+    }
+    int n = base << levels;
+    size_t temporaries = 0;
+    for (int h = n / 2; h >= base; h /= 2) {
+      temporaries += 2 * size_t(h) * h;
+    }
+    vt work(3 * size_t(n) * n + temporaries, T(0));
+    T* pa = &work[0];
+    T* pb = pa + size_t(n) * n;
+    T* pc = pb + size_t(n) * n;
+    for (int j = 0; j < a.rows(); j++) {
+      std::copy(a[j].begin(), a[j].end(), pa + size_t(j) * n);
+    }
+    for (int j = 0; j < b.rows(); j++) {
+      std::copy(b[j].begin(), b[j].end(), pb + size_t(j) * n);
+    }
+    winograd(pa, n, pb, n, pc, n, n, base, pc + size_t(n) * n);
+    for (int j = 0; j < ans.rows(); j++) {
+      std::copy(pc + size_t(j) * n, pc + size_t(j) * n + ans.cols(),
+                ans[j].begin());
+    }
+  }
+
+  // c = a * b for n x n blocks with row strides sa, sb, sc, in the 22-step
+  // Strassen-Winograd schedule: 7 half-size products and 15 additions,
+  // using c's quadrants and two temporaries x, y as the only scratch.
+  static void winograd(const T* a, int sa, const T* b, int sb, T* c, int sc,
+                       int n, int base, T* work) {
+    if (n == base) {
+      kernel(a, sa, b, sb, c, sc, n);
+      return;
+    }
+    int h = n / 2;
+    const T *a11 = a, *a12 = a + h, *a21 = a + size_t(h) * sa, *a22 = a21 + h;
+    const T *b11 = b, *b12 = b + h, *b21 = b + size_t(h) * sb, *b22 = b21 + h;
+    T *c11 = c, *c12 = c + h, *c21 = c + size_t(h) * sc, *c22 = c21 + h;
+    T* x = work;
+    T* y = x + size_t(h) * h;
+    T* next = y + size_t(h) * h;
+    sub(a11, sa, a21, sa, x, h, h);
+    sub(b22, sb, b12, sb, y, h, h);
+    winograd(x, h, y, h, c21, sc, h, base, next);
+    add(a21, sa, a22, sa, x, h, h);
+    sub(b12, sb, b11, sb, y, h, h);
+    winograd(x, h, y, h, c22, sc, h, base, next);
+    sub(x, h, a11, sa, x, h, h);
+    sub(b22, sb, y, h, y, h, h);
+    winograd(x, h, y, h, c12, sc, h, base, next);
+    sub(a12, sa, x, h, x, h, h);
+    winograd(x, h, b22, sb, c11, sc, h, base, next);
+    winograd(a11, sa, b11, sb, x, h, h, base, next);
+    add(x, h, c12, sc, c12, sc, h);
+    add(c12, sc, c21, sc, c21, sc, h);
+    add(c12, sc, c22, sc, c12, sc, h);
+    add(c21, sc, c22, sc, c22, sc, h);
+    add(c12, sc, c11, sc, c12, sc, h);
+    sub(y, h, b21, sb, y, h, h);
+    winograd(a22, sa, y, h, c11, sc, h, base, next);
+    sub(c21, sc, c11, sc, c21, sc, h);
+    winograd(a12, sa, b21, sb, c11, sc, h, base, next);
+    add(x, h, c11, sc, c11, sc, h);
+  }
+
+  // Base case in i-k-j order, so the inner loop runs along rows of b and c.
+  static void kernel(const T* a, int sa, const T* b, int sb, T* c, int sc,
+                     int n) {
+    INSTRUMENT_COUNT("matrix.multiply_adds", static_cast<long long>(n) * n * n);
+    for (int j = 0; j < n; j++) {
+      T* cj = c + size_t(j) * sc;
+      std::fill(cj, cj + n, T(0));
+      for (int k = 0; k < n; k++) {
+        const T ajk = a[size_t(j) * sa + k];
+        const T* bk = b + size_t(k) * sb;
+        for (int i = 0; i < n; i++) {
+          cj[i] = cj[i] + ajk * bk[i];
+        }
+      }
+    }
+  }
+
+  static void add(const T* a, int sa, const T* b, int sb, T* c, int sc,
+                  int n) {
+    for (int j = 0; j < n; j++) {
+      std::transform(a + size_t(j) * sa, a + size_t(j) * sa + n,
+                     b + size_t(j) * sb, c + size_t(j) * sc, std::plus<T>());
+    }
+  }
+
+  static void sub(const T* a, int sa, const T* b, int sb, T* c, int sc,
+                  int n) {
+    for (int j = 0; j < n; j++) {
+      std::transform(a + size_t(j) * sa, a + size_t(j) * sa + n,
+                     b + size_t(j) * sb, c + size_t(j) * sc, std::minus<T>());
+    }
+  }
+
   vvt mat_;
-  int rows_, cols_;
+  int rows_, cols_, strassen_;
   mutable matrix<T>* id_cache_;
 };
+
+// Matrix over GF(2), one bit per entry: rows are arrays of 64-bit words,
+// so a row operation handles 64 columns per XOR (128 with SSE2), and the
+// matrix takes 1/32 of the memory of matrix<int>. Rows are padded to an
+// even number of words, and padding bits are always zero.
+class gf2matrix {
+ public:
+  gf2matrix(int rows, int cols)
+      : rows_(rows), cols_(cols), words_((cols + 127) / 128 * 2),
+        data_(rows * words_) {
+  }
+
+  // Takes rows * cols values in row-major order, keeping the lowest bit.
+  template<typename Iterator>
+  gf2matrix(int rows, int cols, Iterator data)
+      : rows_(rows), cols_(cols), words_((cols + 127) / 128 * 2),
+        data_(rows * words_) {
+    for (int j = 0; j < rows; j++) {
+      for (int i = 0; i < cols; i++) {
+        set(j, i, *data & 1);
+        ++data;
+      }
+    }
+  }
+
+  int rows() const {
+    return rows_;
+  }
+
+  int cols() const {
+    return cols_;
+  }
+
+  bool get(int row, int col) const {
+    return data_[row * words_ + col / 64] >> (col % 64) & 1;
+  }
+
+  void set(int row, int col, bool value) {
+    uint64_t& word = data_[row * words_ + col / 64];
+    word = (word & ~(1ULL << (col % 64))) | (uint64_t(value) << (col % 64));
+  }
+
+  // Words of a row, column c in bit c % 64 of word c / 64.
+  uint64_t* row(int r) {
+    return &data_[r * words_];
+  }
+
+  const uint64_t* row(int r) const {
+    return &data_[r * words_];
+  }
+
+  gf2matrix id() const {
+    gf2matrix ans(rows_, cols_);
+    for (int i = 0; i < std::min(rows_, cols_); i++) {
+      ans.set(i, i, true);
+    }
+    return ans;
+  }
+
+  bool operator==(const gf2matrix& b) const {
+    return rows_ == b.rows_ && cols_ == b.cols_ && data_ == b.data_;
+  }
+
+  bool operator!=(const gf2matrix& b) const {
+    return !(*this == b);
+  }
+
+  gf2matrix operator+(const gf2matrix& b) const {
+    gf2matrix ans(*this);
+    for (int j = 0; j < rows_; j++) {
+      add_row(ans.row(j), b.row(j), 0, words_);
+    }
+    return ans;
+  }
+
+  // Row j of the product is the XOR of the rows of b selected by row j.
+  gf2matrix operator*(const gf2matrix& b) const {
+    gf2matrix ans(rows_, b.cols_);
+    for (int j = 0; j < rows_; j++) {
+      const uint64_t* r = row(j);
+      for (int w = 0; w < words_; w++) {
+        for (uint64_t bits = r[w]; bits; bits &= bits - 1) {
+          int k = w * 64 + __builtin_ctzll(bits);
+          add_row(ans.row(j), b.row(k), 0, b.words_);
+        }
+      }
+    }
+    return ans;
+  }
+
+  template <typename S>
+  gf2matrix power(S n) const {
+    gf2matrix ans(id()), b(*this);
+    for (S exp = n; exp; exp >>= 1) {
+      if (exp & 1) {
+        ans = ans * b;
+      }
+      b = b * b;
+    }
+    return ans;
+  }
+
+  int rank() const {
+    gf2matrix m(*this);
+    std::vector<int> pivots;
+    return m.eliminate(cols_, pivots);
+  }
+
+  // Some x with A x = b (free variables set to zero), or false if the
+  // system has no solution.
+  bool solve(const std::vector<bool>& b, std::vector<bool>& x) const {
+    gf2matrix m(rows_, cols_ + 1);
+    for (int j = 0; j < rows_; j++) {
+      std::copy(row(j), row(j) + words_, m.row(j));
+      m.set(j, cols_, b[j]);
+    }
+    std::vector<int> pivots;
+    int rank = m.eliminate(cols_, pivots);
+    for (int j = rank; j < rows_; j++) {
+      if (m.get(j, cols_)) {
+        return false;
+      }
+    }
+    x.assign(cols_, false);
+    for (int j = 0; j < rank; j++) {
+      x[pivots[j]] = m.get(j, cols_);
+    }
+    return true;
+  }
+
+  std::pair<bool, gf2matrix> inverse() const {
+    if (rows_ != cols_) {
+      return std::make_pair(false, *this);
+    }
+    int n = rows_;
+    gf2matrix m(n, 2 * n);
+    for (int j = 0; j < n; j++) {
+      std::copy(row(j), row(j) + words_, m.row(j));
+      m.set(j, n + j, true);
+    }
+    std::vector<int> pivots;
+    if (m.eliminate(n, pivots) < n) {
+      return std::make_pair(false, *this);
+    }
+    gf2matrix ans(n, n);
+    for (int j = 0; j < n; j++) {
+      for (int i = 0; i < n; i++) {
+        ans.set(j, i, m.get(j, n + i));
+      }
+    }
+    return std::make_pair(true, ans);
+  }
+
+  // Basis of {x : A x = 0}, one vector per row.
+  gf2matrix nullspace() const {
+    gf2matrix m(*this);
+    std::vector<int> pivots;
+    int rank = m.eliminate(cols_, pivots);
+    std::vector<bool> pivot(cols_, false);
+    for (int j = 0; j < rank; j++) {
+      pivot[pivots[j]] = true;
+    }
+    gf2matrix ans(cols_ - rank, cols_);
+    for (int i = 0, k = 0; i < cols_; i++) {
+      if (pivot[i]) {
+        continue;
+      }
+      ans.set(k, i, true);
+      for (int j = 0; j < rank; j++) {
+        ans.set(k, pivots[j], m.get(j, i));
+      }
+      k++;
+    }
+    return ans;
+  }
+
+ private:
+  // Gauss-Jordan over the first limit columns: on return the first rank
+  // rows are reduced, row j has its leading one in column pivots[j], and
+  // the other rows are zero within the limit. Rows from the current rank
+  // on are zero left of the column being reduced, so every XOR can start
+  // at that column's word.
+  int eliminate(int limit, std::vector<int>& pivots) {
+    int rank = 0;
+    for (int col = 0; col < limit && rank < rows_; col++) {
+      int w = col / 64;
+      uint64_t bit = 1ULL << (col % 64);
+      int pivot = rank;
+      while (pivot < rows_ && !(row(pivot)[w] & bit)) {
+        pivot++;
+      }
+      if (pivot == rows_) {
+        continue;
+      }
+      if (pivot != rank) {
+        std::swap_ranges(row(pivot) + w, row(pivot) + words_, row(rank) + w);
+      }
+      // Half the rows have the bit set at random, so the XOR is masked
+      // instead of branched on; the pivot row masks itself out.
+      const uint64_t* source = row(rank);
+      for (int j = 0; j < rows_; j++) {
+        uint64_t mask = -((row(j)[w] & bit) >> (col % 64));
+        add_row(row(j), source, j == rank ? 0 : mask, w & ~1, words_);
+      }
+      pivots.push_back(col);
+      rank++;
+    }
+    return rank;
+  }
+
+  // target ^= source over words [begin, end), both even.
+  static void add_row(uint64_t* target, const uint64_t* source,
+                      int begin, int end) {
+    add_row(target, source, ~0ULL, begin, end);
+  }
+
+  // target ^= source & mask over words [begin, end), both even.
+  static void add_row(uint64_t* target, const uint64_t* source,
+                      uint64_t mask, int begin, int end) {
+#ifdef __SSE2__
+    __m128i m = _mm_set1_epi64x(mask);
+    for (int w = begin; w < end; w += 2) {
+      __m128i* t = reinterpret_cast<__m128i*>(target + w);
+      __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + w));
+      _mm_storeu_si128(t, _mm_xor_si128(_mm_loadu_si128(t),
+                                        _mm_and_si128(s, m)));
+    }
+#else
+    for (int w = begin; w < end; w++) {
+      target[w] ^= source[w] & mask;
+    }
+#endif
+  }
+
+  int rows_, cols_, words_;
+  std::vector<uint64_t> data_;
+};
@@ -0,0 +1,183 @@
+#include <vector>
+#include "bench.h"
+#include "bigint.h"
+#include "modint.h"
+#include "matrix.h"
+
+typedef modint<1000000007> mint;
+
+template<typename T>
+matrix<T> random_matrix(int n, unsigned seed) {
+  matrix<T> m(n, n);
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < n; i++) {
+      seed = seed * 1103515245 + 12345;
+      m[j][i] = T(int(seed >> 20));
+    }
+  }
+  return m;
+}
+
+template<typename T>
+void multiply(BenchState& state) {
+  matrix<T> a = random_matrix<T>(state.arg(), 1);
+  matrix<T> b = random_matrix<T>(state.arg(), 2);
+  while (state.run()) {
+    do_not_optimize(a * b);
+  }
+}
+
+BENCH(MultiplyInt, 4, 32, 128) { multiply<int>(state); }
+BENCH(MultiplyLongLong, 4, 32, 128) { multiply<long long>(state); }
+BENCH(MultiplyDouble, 4, 32, 128) { multiply<double>(state); }
+BENCH(MultiplyModint, 4, 32, 128) { multiply<mint>(state); }
+BENCH(MultiplyBigint, 4, 16) { multiply<bigint>(state); }
+
+template<typename T>
+void strassen(BenchState& state, int threshold) {
+  matrix<T> a = random_matrix<T>(state.arg(), 1);
+  matrix<T> b = random_matrix<T>(state.arg(), 2);
+  a.set_strassen(threshold);
+  while (state.run()) {
+    do_not_optimize(a * b);
+  }
+}
+
+BENCH(MultiplyModintLarge, 256, 512) { multiply<mint>(state); }
+BENCH(StrassenModint, 256, 512) { strassen<mint>(state, 32); }
+BENCH(MultiplyLongLongLarge, 256, 512) { multiply<long long>(state); }
+BENCH(StrassenLongLong, 256, 512) { strassen<long long>(state, 32); }
+
+// Linear recurrences: a small companion matrix raised to a large power.
+BENCH(PowerModint, 2, 8, 32) {
+  matrix<mint> a = random_matrix<mint>(state.arg(), 1);
+  while (state.run()) {
+    do_not_optimize(a.power(1000000000));
+  }
+}
+
+// A^k v: forming A^k and multiplying, against squaring applied to v and
+// reduction by the characteristic polynomial.
+BENCH(PowerTimesVector, 16, 64, 128) {
+  matrix<mint> a = random_matrix<mint>(state.arg(), 1);
+  matrix<mint> v = random_matrix<mint>(state.arg(), 2);
+  while (state.run()) {
+    matrix<mint> p = a.power(1000000000000000000LL);
+    matrix<mint>::vt ans(state.arg());
+    for (int j = 0; j < state.arg(); j++) {
+      for (int i = 0; i < state.arg(); i++) {
+        ans[j] = ans[j] + p[j][i] * v[0][i];
+      }
+    }
+    do_not_optimize(ans);
+  }
+}
+
+BENCH(ApplyPower, 16, 64, 128) {
+  matrix<mint> a = random_matrix<mint>(state.arg(), 1);
+  matrix<mint> v = random_matrix<mint>(state.arg(), 2);
+  while (state.run()) {
+    do_not_optimize(a.apply_power(1000000000000000000LL, v[0]));
+  }
+}
+
+BENCH(ApplyPowerCharpoly, 16, 64, 128) {
+  matrix<mint> a = random_matrix<mint>(state.arg(), 1);
+  matrix<mint> v = random_matrix<mint>(state.arg(), 2);
+  while (state.run()) {
+    do_not_optimize(a.apply_power(1000000000000000000LL, v[0],
+                                  a.charpoly()));
+  }
+}
+
+BENCH(InverseDouble, 8, 32, 128) {
+  matrix<double> a = random_matrix<double>(state.arg(), 1);
+  while (state.run()) {
+    do_not_optimize(a.inverse());
+  }
+}
+
+// Cofactor expansion is O(n!), so only tiny sizes are meaningful.
+BENCH(DeterminantLongLong, 4, 8) {
+  matrix<long long> a = random_matrix<long long>(state.arg(), 1);
+  while (state.run()) {
+    do_not_optimize(a.determinant());
+  }
+}
+
+// The 64-bit generator keeps large matrices at full rank; single bits of
+// the 32-bit one repeat too soon.
+gf2matrix random_gf2matrix(int n, unsigned long long seed) {
+  gf2matrix m(n, n);
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < n; i++) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      m.set(j, i, seed >> 40 & 1);
+    }
+  }
+  return m;
+}
+
+// Rank of a 0/1 matrix the old way: matrix<int> and elimination mod 2.
+int rank_mod2(matrix<int> m) {
+  int rank = 0;
+  for (int col = 0; col < m.cols() && rank < m.rows(); col++) {
+    int pivot = rank;
+    while (pivot < m.rows() && m[pivot][col] == 0) {
+      pivot++;
+    }
+    if (pivot == m.rows()) {
+      continue;
+    }
+    for (int i = 0; i < m.cols(); i++) {
+      std::swap(m[pivot][i], m[rank][i]);
+    }
+    for (int j = 0; j < m.rows(); j++) {
+      if (j != rank && m[j][col]) {
+        for (int i = 0; i < m.cols(); i++) {
+          m[j][i] = (m[j][i] + m[rank][i]) % 2;
+        }
+      }
+    }
+    rank++;
+  }
+  return rank;
+}
+
+BENCH(RankMod2Int, 64, 256, 1024) {
+  gf2matrix g = random_gf2matrix(state.arg(), 1);
+  matrix<int> a(state.arg(), state.arg());
+  for (int j = 0; j < a.rows(); j++) {
+    for (int i = 0; i < a.cols(); i++) {
+      a[j][i] = g.get(j, i);
+    }
+  }
+  while (state.run()) {
+    do_not_optimize(rank_mod2(a));
+  }
+}
+
+BENCH(RankGf2, 64, 256, 1024, 4096) {
+  gf2matrix a = random_gf2matrix(state.arg(), 1);
+  while (state.run()) {
+    do_not_optimize(a.rank());
+  }
+}
+
+BENCH(SolveGf2, 64, 256, 1024, 4096) {
+  gf2matrix a = random_gf2matrix(state.arg(), 1);
+  std::vector<bool> b(state.arg()), x;
+  for (int i = 0; i < state.arg(); i += 3) {
+    b[i] = true;
+  }
+  while (state.run()) {
+    do_not_optimize(a.solve(b, x));
+  }
+}
+
+BENCH(InverseGf2, 64, 256, 1024) {
+  gf2matrix a = random_gf2matrix(state.arg(), 1);
+  while (state.run()) {
+    do_not_optimize(a.inverse());
+  }
+}
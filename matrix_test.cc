@@ -1,6 +1,7 @@
 #include <utility>
 #include "gtest/gtest.h"
 #include "matrix.h"
+#include "modint.h"
 
 using namespace std;
 
@@ -109,3 +110,225 @@ TEST(MatrixTest, Inverse) {
   EXPECT_TRUE(pb.first);
   compare_double_matrix(mbexp, pb.second);
 }
+
+template<typename T>
+matrix<T> random_matrix(int rows, int cols, unsigned seed) {
+  matrix<T> m(rows, cols);
+  for (int j = 0; j < rows; j++) {
+    for (int i = 0; i < cols; i++) {
+      seed = seed * 1103515245 + 12345;
+      m[j][i] = T(int(seed >> 16) % 1000 - 500);
+    }
+  }
+  return m;
+}
+
+TEST(MatrixTest, Strassen) {
+  typedef modint<1000000007> mint;
+  // Square, odd and rectangular shapes, so every padding path runs.
+  const static int shapes[][3] = {{8, 8, 8}, {37, 37, 37}, {20, 45, 13},
+                                  {64, 1, 64}, {3, 50, 2}};
+  for (int s = 0; s < 5; s++) {
+    const int* d = shapes[s];
+    matrix<mint> a = random_matrix<mint>(d[0], d[1], s);
+    matrix<mint> b = random_matrix<mint>(d[1], d[2], s + 10);
+    matrix<mint> fast(a);
+    fast.set_strassen(4);
+    EXPECT_EQ(a * b, fast * b);
+    matrix<long long> c = random_matrix<long long>(d[0], d[1], s);
+    matrix<long long> e = random_matrix<long long>(d[1], d[2], s + 10);
+    matrix<long long> fastc(c);
+    fastc.set_strassen(3);
+    EXPECT_EQ(c * e, fastc * e);
+  }
+}
+
+TEST(MatrixTest, StrassenPower) {
+  typedef modint<998244353> mint;
+  matrix<mint> a = random_matrix<mint>(30, 30, 7);
+  matrix<mint> fast(a);
+  fast.set_strassen(8);
+  EXPECT_EQ(a.power(1000000007), fast.power(1000000007));
+}
+
+TEST(MatrixTest, ApplyPower) {
+  typedef modint<1000000007> mint;
+  matrix<mint> a = random_matrix<mint>(12, 12, 3);
+  vector<matrix<mint>::vt> vs;
+  for (int j = 0; j < 3; j++) {
+    vs.push_back(random_matrix<mint>(1, 12, j + 20)[0]);
+  }
+  const static long long ks[] = {0, 1, 5, 12, 13, 1000000000000LL};
+  for (int t = 0; t < 6; t++) {
+    matrix<mint> p = a.power(ks[t]);
+    vector<matrix<mint>::vt> fast = a.apply_power(ks[t], vs);
+    ASSERT_EQ(3u, fast.size());
+    for (int j = 0; j < 3; j++) {
+      matrix<mint>::vt expected(12);
+      for (int r = 0; r < 12; r++) {
+        for (int c = 0; c < 12; c++) {
+          expected[r] = expected[r] + p[r][c] * vs[j][c];
+        }
+      }
+      EXPECT_EQ(expected, fast[j]);
+      EXPECT_EQ(expected, a.apply_power(ks[t], vs[j]));
+      EXPECT_EQ(expected, a.apply_power(ks[t], vs[j], a.charpoly()));
+    }
+  }
+}
+
+TEST(MatrixTest, Charpoly) {
+  typedef modint<1000000007> mint;
+  // det(xI - A) = x^2 - 5x - 2 for {{1, 2}, {3, 4}}.
+  const static int a[] = {1, 2, 3, 4};
+  matrix<mint>::vt p = matrix<mint>(2, 2, a).charpoly();
+  ASSERT_EQ(3u, p.size());
+  EXPECT_EQ(mint(-2), p[0]);
+  EXPECT_EQ(mint(-5), p[1]);
+  EXPECT_EQ(mint(1), p[2]);
+
+  // Zeros below the diagonal force the pivot search; Cayley-Hamilton
+  // must hold either way.
+  const static int b[] = {1, 2, 0, 0, 0, 3, 0, 1, 2, 1, 4, 0, 0, 0, 5, 1};
+  matrix<mint> mb(4, 4, b);
+  matrix<mint>::vt q = mb.charpoly();
+  matrix<mint> sum(4, 4), term(mb.id());
+  for (int d = 0; d <= 4; d++) {
+    for (int j = 0; j < 4; j++) {
+      for (int i = 0; i < 4; i++) {
+        sum[j][i] = sum[j][i] + q[d] * term[j][i];
+      }
+    }
+    term = term * mb;
+  }
+  EXPECT_EQ(matrix<mint>(4, 4), sum);
+}
+
+TEST(MatrixTest, CharpolyDouble) {
+  // A tiny entry under the diagonal would be a ruinous pivot.
+  const static double a[] = {1, 2, 3, 1e-13, 4, 5, 1, 6, 7};
+  matrix<double>::vt p = matrix<double>(3, 3, a).charpoly();
+  ASSERT_EQ(4u, p.size());
+  EXPECT_NEAR(4.0, p[0], 1e-9);
+  EXPECT_NEAR(6.0, p[1], 1e-9);
+  EXPECT_NEAR(-12.0, p[2], 1e-9);
+  EXPECT_EQ(1.0, p[3]);
+}
+
+TEST(MatrixTest, Empty) {
+  typedef modint<1000000007> mint;
+  matrix<mint> m(0, 0);
+  matrix<mint>::vt p = m.charpoly();
+  ASSERT_EQ(1u, p.size());
+  EXPECT_EQ(mint(1), p[0]);
+  EXPECT_TRUE(m.apply_power(10, matrix<mint>::vt(), p).empty());
+  EXPECT_TRUE(m.apply_power(10, matrix<mint>::vt()).empty());
+}
+
+gf2matrix random_gf2matrix(int rows, int cols, unsigned seed) {
+  gf2matrix m(rows, cols);
+  for (int j = 0; j < rows; j++) {
+    for (int i = 0; i < cols; i++) {
+      seed = seed * 1103515245 + 12345;
+      m.set(j, i, seed >> 20 & 1);
+    }
+  }
+  return m;
+}
+
+TEST(Gf2MatrixTest, Assign) {
+  const static int a[] = {1, 0, 3, 2, 5, 7};
+  gf2matrix m(2, 3, a);
+  EXPECT_TRUE(m.get(0, 0));
+  EXPECT_FALSE(m.get(0, 1));
+  EXPECT_TRUE(m.get(0, 2));
+  EXPECT_FALSE(m.get(1, 0));
+  EXPECT_TRUE(m.get(1, 1));
+  EXPECT_TRUE(m.get(1, 2));
+  m.set(1, 2, false);
+  EXPECT_FALSE(m.get(1, 2));
+  EXPECT_EQ(5u, m.row(0)[0]);
+  EXPECT_EQ(2u, m.row(1)[0]);
+}
+
+TEST(Gf2MatrixTest, Multiply) {
+  const static int a[] = {1, 1, 1, 0};
+  const static int f[] = {1, 0, 0, 1};
+  gf2matrix m(2, 2, a);
+  // Fibonacci mod 2 has period 3.
+  EXPECT_EQ(gf2matrix(2, 2, f), m.power(3));
+  EXPECT_EQ(m * m * m * m, m.power(4));
+  EXPECT_EQ(gf2matrix(2, 2), m + m);
+}
+
+TEST(Gf2MatrixTest, Rank) {
+  const static int a[] = {1, 1, 0, 0, 1, 1, 1, 0, 1};
+  EXPECT_EQ(2, gf2matrix(3, 3, a).rank());
+  EXPECT_EQ(0, gf2matrix(5, 200).rank());
+  gf2matrix m = random_gf2matrix(300, 200, 1);
+  EXPECT_EQ(200, m.rank());
+  EXPECT_EQ(200, m.id().rank());
+}
+
+TEST(Gf2MatrixTest, Solve) {
+  gf2matrix m = random_gf2matrix(150, 130, 2);
+  vector<bool> x0(130), b(150), x;
+  for (int i = 0; i < 130; i++) {
+    x0[i] = i % 3 == 0;
+  }
+  for (int j = 0; j < 150; j++) {
+    for (int i = 0; i < 130; i++) {
+      b[j] = b[j] ^ (m.get(j, i) && x0[i]);
+    }
+  }
+  ASSERT_TRUE(m.solve(b, x));
+  for (int j = 0; j < 150; j++) {
+    bool sum = false;
+    for (int i = 0; i < 130; i++) {
+      sum ^= m.get(j, i) && x[i];
+    }
+    EXPECT_EQ(b[j], sum);
+  }
+
+  const static int a[] = {1, 1, 1, 1};
+  vector<bool> c(2);
+  c[0] = true;
+  EXPECT_FALSE(gf2matrix(2, 2, a).solve(c, x));
+}
+
+TEST(Gf2MatrixTest, Inverse) {
+  const static int a[] = {1, 1, 0, 0, 1, 1, 0, 0, 1};
+  gf2matrix m(3, 3, a);
+  pair<bool, gf2matrix> p = m.inverse();
+  ASSERT_TRUE(p.first);
+  EXPECT_EQ(m.id(), m * p.second);
+  EXPECT_EQ(m.id(), p.second * m);
+
+  gf2matrix r = random_gf2matrix(129, 129, 3);
+  p = r.inverse();
+  EXPECT_EQ(r.rank() == 129, p.first);
+  if (p.first) {
+    EXPECT_EQ(r.id(), r * p.second);
+  }
+
+  const static int s[] = {1, 1, 0, 0, 1, 1, 1, 0, 1};
+  EXPECT_FALSE(gf2matrix(3, 3, s).inverse().first);
+  EXPECT_FALSE(gf2matrix(1, 200).inverse().first);
+  EXPECT_FALSE(gf2matrix(200, 1).inverse().first);
+}
+
+TEST(Gf2MatrixTest, Nullspace) {
+  gf2matrix m = random_gf2matrix(70, 100, 4);
+  gf2matrix k = m.nullspace();
+  EXPECT_EQ(100 - m.rank(), k.rows());
+  EXPECT_EQ(k.rows(), k.rank());
+  for (int v = 0; v < k.rows(); v++) {
+    for (int j = 0; j < m.rows(); j++) {
+      bool sum = false;
+      for (int i = 0; i < 100; i++) {
+        sum ^= m.get(j, i) && k.get(v, i);
+      }
+      EXPECT_FALSE(sum);
+    }
+  }
+}
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//reserve memo MemoHash MemoStats hits misses evictions
+
+// Hash of memo keys: integers go through a 64-bit mixer, pairs and tuples
+// combine their elements, anything else falls back to std::hash.
+template<typename T, typename Enable = void>
+struct MemoHash {
+  size_t operator()(const T& x) const {
+    return std::hash<T>()(x);
+  }
+};
+
+inline unsigned long long memo_mix(unsigned long long x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+template<typename T>
+struct MemoHash<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+  size_t operator()(const T& x) const {
+    return memo_mix(static_cast<unsigned long long>(x));
+  }
+};
+
+template<typename A, typename B>
+struct MemoHash<std::pair<A, B> > {
+  size_t operator()(const std::pair<A, B>& x) const {
+    return memo_mix(MemoHash<A>()(x.first) * 31 + MemoHash<B>()(x.second));
+  }
+};
+
+template<typename... Args>
+struct MemoHash<std::tuple<Args...> > {
+  size_t operator()(const std::tuple<Args...>& x) const {
+    return combine(x, std::index_sequence_for<Args...>());
+  }
+
+ private:
+  template<size_t... I>
+  static size_t combine(const std::tuple<Args...>& x,
+                        std::index_sequence<I...>) {
+    unsigned long long h = 0;
+    int expand[] = {0, (h = memo_mix(h * 31 + MemoHash<
+        typename std::tuple_element<I, std::tuple<Args...> >::type>()(
+            std::get<I>(x))), 0)...};
+    (void)expand;
+    return h;
+  }
+};
+
+struct MemoStats {
+  MemoStats() : hits(0), misses(0), evictions(0) {}
+  long long hits, misses, evictions;
+};
+
+template<typename Signature>
+class memo;
+
+// Memoizes a function in a flat open-addressing table of fixed capacity,
+// so memory stays bounded. A key lives in one of the WINDOW slots after its
+// hash; when they are all taken, a CLOCK sweep over the window evicts the
+// first entry not used since the previous sweep. The function receives the
+// memo itself to recurse through the cache:
+//
+//   typedef memo<long long(int, int)> memo_paths;
+//   memo_paths paths([](memo_paths& self, int i, int j) -> long long {
+//     return i == 0 || j == 0 ? 1 : self(i - 1, j) + self(i, j - 1);
+//   });
+//
+// With shared = true, lookups and inserts take a mutex, so threads can share
+// one cache. The function itself runs unlocked and may recurse; two threads
+// may then compute the same value, and both store the same result.
+template<typename R, typename... Args>
+class memo<R(Args...)> {
+ public:
+  typedef std::tuple<typename std::decay<Args>::type...> key_type;
+  typedef std::function<R(memo&, Args...)> function_type;
+
+  explicit memo(function_type function, size_t capacity = 1 << 20,
+                bool shared = false)
+      : function_(function), shared_(shared), hand_(0) {
+    size_t size = WINDOW;
+    while (size < capacity) {
+      size *= 2;
+    }
+    slots_.resize(size);
+    mask_ = size - 1;
+  }
+
+  R operator()(Args... args) {
+    key_type key(args...);
+    size_t start = MemoHash<key_type>()(key) & mask_;
+    {
+      std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+      if (shared_) {
+        lock.lock();
+      }
+      Slot* slot = find(key, start);
+      if (slot != NULL) {
+        stats_.hits++;
+        slot->used = true;
+        return slot->value;
+      }
+      stats_.misses++;
+    }
+    R value = function_(*this, args...);
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (shared_) {
+      lock.lock();
+    }
+    insert(key, start, value);
+    return value;
+  }
+
+  // A copy, since a shared cache keeps counting while it is read.
+  MemoStats stats() const {
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (shared_) {
+      lock.lock();
+    }
+    return stats_;
+  }
+
+  size_t capacity() const {
+    return slots_.size();
+  }
+
+  void clear() {
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (shared_) {
+      lock.lock();
+    }
+    std::fill(slots_.begin(), slots_.end(), Slot());
+    stats_ = MemoStats();
+  }
+
+ private:
+  static const int WINDOW = 8;
+
+  struct Slot {
+    Slot() : full(false), used(false) {}
+    key_type key;
+    R value;
+    bool full, used;
+  };
+
+  // Slots fill in probe order and are never emptied, except by clear(), so
+  // the search stops at the first empty slot.
+  Slot* find(const key_type& key, size_t start) {
+    for (int i = 0; i < WINDOW; i++) {
+      Slot& slot = slots_[(start + i) & mask_];
+      if (!slot.full) {
+        return NULL;
+      }
+      if (slot.key == key) {
+        return &slot;
+      }
+    }
+    return NULL;
+  }
+
+  void insert(const key_type& key, size_t start, const R& value) {
+    Slot* target = NULL;
+    for (int i = 0; i < WINDOW && target == NULL; i++) {
+      Slot& slot = slots_[(start + i) & mask_];
+      if (!slot.full || slot.key == key) {
+        target = &slot;
+      }
+    }
+    if (target == NULL) {
+      // The window is full: sweep it from the clock hand, clearing use
+      // bits, and take the first slot whose bit was already clear.
+      for (int i = 0; target == NULL; i++) {
+        Slot& slot = slots_[(start + (hand_ + i) % WINDOW) & mask_];
+        if (slot.used) {
+          slot.used = false;
+        } else {
+          target = &slot;
+          hand_ = (hand_ + i + 1) % WINDOW;
+        }
+      }
+      stats_.evictions++;
+    }
+    target->key = key;
+    target->value = value;
+    target->full = true;
+    target->used = false;
+  }
+
+  function_type function_;
+  std::vector<Slot> slots_;
+  size_t mask_;
+  bool shared_;
+  int hand_;
+  MemoStats stats_;
+  mutable std::mutex mutex_;
+};
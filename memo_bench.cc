@@ -0,0 +1,65 @@
+#include <map>
+#include <unordered_map>
+#include "bench.h"
+#include "lazy.h"
+#include "memo.h"
+
+typedef memo<llint(int, int)> memo_paths;
+
+// Lattice paths through an n x n grid, recursing through the cache.
+BENCH(MemoPaths, 100, 1000) {
+  int n = state.arg();
+  while (state.run()) {
+    memo_paths paths([](memo_paths& self, int i, int j) -> llint {
+      return i == 0 || j == 0 ? 1 : self(i - 1, j) + self(i, j - 1);
+    }, 2 * (n + 1) * (n + 1));
+    for (int i = 0; i <= n; i++) {
+      do_not_optimize(paths(i, n));
+    }
+  }
+}
+
+struct PairHash {
+  size_t operator()(const pii& x) const {
+    return MemoHash<pii>()(x);
+  }
+};
+
+// The same recursion with a hand-written std::unordered_map cache.
+llint unordered_paths(std::unordered_map<pii, llint, PairHash>& cache,
+                      int i, int j) {
+  if (i == 0 || j == 0) {
+    return 1;
+  }
+  std::unordered_map<pii, llint, PairHash>::iterator it =
+      cache.find(pii(i, j));
+  if (it != cache.end()) {
+    return it->second;
+  }
+  llint ans = unordered_paths(cache, i - 1, j) + unordered_paths(cache, i, j - 1);
+  cache[pii(i, j)] = ans;
+  return ans;
+}
+
+BENCH(UnorderedMapPaths, 100, 1000) {
+  int n = state.arg();
+  while (state.run()) {
+    std::unordered_map<pii, llint, PairHash> cache;
+    for (int i = 0; i <= n; i++) {
+      do_not_optimize(unordered_paths(cache, i, n));
+    }
+  }
+}
+
+// A cache of 1/16 of the subproblems: evictions force recomputation.
+BENCH(MemoPathsBounded, 100) {
+  int n = state.arg();
+  while (state.run()) {
+    memo_paths paths([](memo_paths& self, int i, int j) -> llint {
+      return i == 0 || j == 0 ? 1 : self(i - 1, j) + self(i, j - 1);
+    }, (n + 1) * (n + 1) / 16);
+    for (int i = 0; i <= n; i++) {
+      do_not_optimize(paths(i, n));
+    }
+  }
+}
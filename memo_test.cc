@@ -0,0 +1,110 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "lazy.h"
+#include "memo.h"
+
+typedef memo<llint(int)> memo_fib;
+
+TEST(MemoTest, Fibonacci) {
+  int calls = 0;
+  memo_fib fib([&calls](memo_fib& self, int n) -> llint {
+    calls++;
+    return n < 2 ? n : self(n - 1) + self(n - 2);
+  });
+  EXPECT_EQ(2880067194370816120LL, fib(90));
+  EXPECT_EQ(91, calls);
+  EXPECT_EQ(91, fib.stats().misses);
+  EXPECT_EQ(88, fib.stats().hits);
+  EXPECT_EQ(0, fib.stats().evictions);
+  EXPECT_EQ(55, fib(10));
+  EXPECT_EQ(91, calls);
+  fib.clear();
+  EXPECT_EQ(0, fib.stats().misses);
+  EXPECT_EQ(55, fib(10));
+  EXPECT_EQ(102, calls);
+}
+
+TEST(MemoTest, TwoArguments) {
+  typedef memo<llint(int, int)> memo_paths;
+  memo_paths paths([](memo_paths& self, int i, int j) -> llint {
+    return i == 0 || j == 0 ? 1 : self(i - 1, j) + self(i, j - 1);
+  });
+  // C(60, 30) lattice paths, about 10^17 without the cache.
+  EXPECT_EQ(118264581564861424LL, paths(30, 30));
+  // Every (i, j) in [0, 30]^2 but (0, 0) is computed once.
+  EXPECT_EQ(31 * 31 - 1, paths.stats().misses);
+}
+
+TEST(MemoTest, Eviction) {
+  int calls = 0;
+  memo_fib fib([&calls](memo_fib& self, int n) -> llint {
+    calls++;
+    return n < 2 ? n : self(n - 1) + self(n - 2);
+  }, 8);
+  EXPECT_EQ(8u, fib.capacity());
+  EXPECT_EQ(2880067194370816120LL, fib(90));
+  EXPECT_LT(0, fib.stats().evictions);
+  EXPECT_EQ(calls, fib.stats().misses);
+  for (int n = 90; n >= 0; n--) {
+    EXPECT_EQ(n < 2 ? n : fib(n - 1) + fib(n - 2), fib(n));
+  }
+}
+
+TEST(MemoTest, Keys) {
+  typedef memo<int(const std::string&, pii)> memo_count;
+  memo_count count([](memo_count& self, const std::string& s, pii range) {
+    int ans = 0;
+    for (int i = range.first; i < range.second; i++) {
+      ans += s[i] == 'a';
+    }
+    return ans;
+  });
+  EXPECT_EQ(2, count("banana", pii(0, 4)));
+  EXPECT_EQ(3, count("banana", pii(0, 6)));
+  EXPECT_EQ(0, count("cherry", pii(0, 6)));
+  EXPECT_EQ(2, count("banana", pii(0, 4)));
+  EXPECT_EQ(1, count.stats().hits);
+  EXPECT_EQ(3, count.stats().misses);
+}
+
+TEST(MemoTest, Shared) {
+  typedef memo<llint(int, int)> memo_paths;
+  memo_paths paths([](memo_paths& self, int i, int j) -> llint {
+    return i == 0 || j == 0 ? 1 : self(i - 1, j) + self(i, j - 1);
+  }, 1 << 12, true);
+  std::vector<std::thread> threads;
+  std::vector<llint> ans(4);
+  std::atomic<bool> done(false);
+  // Reads the counters while the workers update them.
+  std::thread reader([&paths, &done] {
+    llint last = 0;
+    while (!done) {
+      MemoStats stats = paths.stats();
+      EXPECT_LE(last, stats.hits + stats.misses);
+      last = stats.hits + stats.misses;
+    }
+  });
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([&paths, &ans, t] {
+      for (int k = 0; k < 100; k++) {
+        ans[t] += paths(20 + t, 20 - t);
+      }
+    }));
+  }
+  for (int t = 0; t < 4; t++) {
+    threads[t].join();
+  }
+  done = true;
+  reader.join();
+  llint expected[] = {137846528820LL, 131282408400LL, 113380261800LL,
+                      88732378800LL};
+  for (int t = 0; t < 4; t++) {
+    EXPECT_EQ(100 * expected[t], ans[t]);
+  }
+  // Every repeated top-level query is a hit.
+  EXPECT_LE(4 * 99, paths.stats().hits);
+  EXPECT_EQ(0, paths.stats().evictions);
+}
@@ -1,22 +1,29 @@
+#include "instrument.h"
+
 //reserve modint inverse
 
+// With a compile-time modulus every operation is constexpr, so tables of
+// modints can be built by the compiler. VARMOD reads M at runtime.
+#undef MODINT_CONSTEXPR
 #ifdef VARMOD
+#define MODINT_CONSTEXPR
 unsigned M = 2;
 #else
+#define MODINT_CONSTEXPR constexpr
 template<unsigned M> // works only for 1 <= M <= 0x7FFFFFFF
 #endif
 class modint {
  public:
-  modint(unsigned v) : value_(v % M) {}
-  modint(int v) : value_(v < 0 ? M + v % int(M) : v % M) {}
-  modint() : value_(0) {}
+  MODINT_CONSTEXPR modint(unsigned v) : value_(v % M) {}
+  MODINT_CONSTEXPR modint(int v) : value_(v < 0 ? M + v % int(M) : v % M) {}
+  MODINT_CONSTEXPR modint() : value_(0) {}
 
-  modint operator+(const modint& b) const {
+  MODINT_CONSTEXPR modint operator+(const modint& b) const {
     unsigned ans = value_ + b.value_;
     return ans < M ? build(ans) : build(ans - M);
   }
 
-  modint& operator+=(const modint& b) {
+  MODINT_CONSTEXPR modint& operator+=(const modint& b) {
     value_ += b.value_;
     if (value_ >= M) {
       value_ -= M;
@@ -24,12 +31,14 @@ class modint {
     return *this;
   }
 
-  modint operator-(const modint& b) const {
+  MODINT_CONSTEXPR modint operator-(const modint& b) const {
     unsigned ans = value_ - b.value_;
     return ans > value_ ? build(ans + M) : build(ans);
   }
 
+#ifdef VARMOD
   modint operator*(const modint& b) const {
+    INSTRUMENT_COUNT("modint.reductions", 1);
     unsigned ans,dummy;
     asm (
       "imull %%ebx\n\t"
@@ -40,15 +49,22 @@ class modint {
     );
     return build(ans);
   }
+#else
+  // The compiler replaces the division by the constant M with multiplies.
+  constexpr modint operator*(const modint& b) const {
+    INSTRUMENT_CONSTEXPR_COUNT("modint.reductions", 1);
+    return build(static_cast<unsigned long long>(value_) * b.value_ % M);
+  }
+#endif
 
-  modint operator-() const {
+  MODINT_CONSTEXPR modint operator-() const {
     return modint(M - value_);
   }
 
   template<typename T>
-  modint power(T n) const {
+  MODINT_CONSTEXPR modint power(T n) const {
     if (n == 0) {
-      return one_;
+      return modint(1U);
     }
     modint half = power(n / 2);
     if (n % 2) {
@@ -58,29 +74,26 @@ class modint {
     }
   }
 
-  modint inverse() const {
+  MODINT_CONSTEXPR modint inverse() const {
+    INSTRUMENT_CONSTEXPR_COUNT("modint.inverses", 1);
     return power(M - 2); // only for M prime!
   }
 
-  operator int() const {
+  MODINT_CONSTEXPR modint operator/(const modint& b) const {
+    return *this * b.inverse(); // only for M prime!
+  }
+
+  MODINT_CONSTEXPR operator int() const {
     return value_;
   }
 
  private:
   unsigned value_;
-  static const modint one_;
 
-  modint build(int v) const {
+  MODINT_CONSTEXPR modint build(unsigned v) const {
     modint ans;
     ans.value_ = v;
     return ans;
   }
 };
 
-#ifdef VARMOD
-const modint modint::one_(1);
-#else
-template<unsigned M>
-const modint<M> modint<M>::one_(1);
-#endif
-
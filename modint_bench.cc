@@ -0,0 +1,76 @@
+#include <vector>
+#include "bench.h"
+#include "modint.h"
+
+typedef modint<1000000007> mint;
+typedef modint<998244353> ntt;
+typedef modint<65537> small;
+
+template<typename T>
+std::vector<T> random_residues(int n) {
+  std::vector<T> values(n);
+  unsigned seed = 12345;
+  for (int i = 0; i < n; i++) {
+    seed = seed * 1103515245 + 12345;
+    values[i] = T(seed >> 1);
+  }
+  return values;
+}
+
+// Dependent chains, so these measure latency rather than throughput.
+template<typename T>
+void multiply_chain(BenchState& state) {
+  std::vector<T> values = random_residues<T>(state.arg());
+  while (state.run()) {
+    T acc(1);
+    for (unsigned i = 0; i < values.size(); i++) {
+      acc = acc * values[i];
+    }
+    do_not_optimize(acc);
+  }
+}
+
+template<typename T>
+void add_chain(BenchState& state) {
+  std::vector<T> values = random_residues<T>(state.arg());
+  while (state.run()) {
+    T acc(0);
+    for (unsigned i = 0; i < values.size(); i++) {
+      acc += values[i];
+    }
+    do_not_optimize(acc);
+  }
+}
+
+BENCH(MultiplyChainMint, 1 << 10, 1 << 16) { multiply_chain<mint>(state); }
+BENCH(MultiplyChainNtt, 1 << 10, 1 << 16) { multiply_chain<ntt>(state); }
+BENCH(MultiplyChainSmall, 1 << 10, 1 << 16) { multiply_chain<small>(state); }
+BENCH(AddChainMint, 1 << 10, 1 << 16) { add_chain<mint>(state); }
+BENCH(AddChainSmall, 1 << 10, 1 << 16) { add_chain<small>(state); }
+
+// Independent products, as in a dot product or a matrix inner loop.
+BENCH(MultiplyArrayMint, 1 << 10, 1 << 16) {
+  std::vector<mint> a = random_residues<mint>(state.arg());
+  std::vector<mint> b(a.rbegin(), a.rend()), c(a.size());
+  while (state.run()) {
+    for (unsigned i = 0; i < a.size(); i++) {
+      c[i] = a[i] * b[i];
+    }
+    do_not_optimize(c);
+  }
+}
+
+BENCH(PowerMint, 1 << 10, 1 << 30) {
+  mint base(123456789);
+  while (state.run()) {
+    do_not_optimize(base.power(state.arg()));
+  }
+}
+
+BENCH(InverseMint, 1) {
+  std::vector<mint> values = random_residues<mint>(1024);
+  int i = 0;
+  while (state.run()) {
+    do_not_optimize(values[i++ & 1023].inverse());
+  }
+}
@@ -63,6 +63,8 @@ TEST(ModintTest, Power) {
 TEST(ModintTest, Inverse) {
   EXPECT_EQ(1, m7(2) * m7(2).inverse());
   EXPECT_EQ(1, m7(3) * m7(3).inverse());
+  EXPECT_EQ(3, m7(1) / m7(5));
+  EXPECT_EQ(6, m7(4) / m7(3));
 }
 
 TEST(ModintTest, Negation) {
@@ -73,6 +75,17 @@ TEST(ModintTest, Negation) {
   EXPECT_EQ(LIMIT - 1, -mhuge(1));
 }
 
+TEST(ModintTest, Constexpr) {
+  static_assert(m7(3) * m7(5) == 1, "product");
+  static_assert(m7(2) - m7(5) == 4, "difference");
+  static_assert(m7(3).inverse() == 5, "inverse");
+  constexpr modint<1000000007> x = modint<1000000007>(2).power(1000000);
+  EXPECT_EQ(x, modint<1000000007>(4).power(500000));
+  EXPECT_EQ(1, x * x.inverse());
+  EXPECT_EQ(LIMIT - 2, mhuge(LIMIT - 1) * mhuge(2));
+  EXPECT_EQ(1, mhuge(LIMIT - 1) * mhuge(LIMIT - 1));
+}
+
 TEST(ModintTest, VarAdd) {
   M = 7;
   EXPECT_EQ(0, varmod(1) + varmod(6));
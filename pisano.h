@@ -0,0 +1,120 @@
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "bigint.h"
+#include "primes.h"
+
+//reserve pisano period nth
+
+// Fibonacci numbers modulo m for arbitrarily large indices. The index is
+// first reduced modulo the Pisano period of m, which is derived from the
+// factorization of m: pi(p^e) = pi(p) * p^(e-1), and pi(p) divides p - 1
+// or 2(p + 1) depending on p mod 5 (the first identity holds for every
+// prime checked so far). Works for 1 <= m <= 0x7FFFFFFF. Periods are
+// cached across instances behind a mutex; the factorization runs unlocked.
+class pisano {
+ public:
+  pisano(int m) : m_(m) {
+    std::map<int, long long>& cache = periods();
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex());
+      std::map<int, long long>::iterator it = cache.find(m);
+      if (it != cache.end()) {
+        period_ = it->second;
+        return;
+      }
+    }
+    std::vector<int> primes =
+        getprimes(static_cast<int>(sqrt(2.0 * m + 2)) + 1);
+    period_ = 1;
+    factorize(m, primes, [&](long long p, int e) {
+      long long pe = prime_period(p, primes);
+      for (int i = 1; i < e; i++) {
+        pe *= p;
+      }
+      period_ = period_ / gcd(period_, pe) * pe;
+    });
+    std::lock_guard<std::mutex> lock(cache_mutex());
+    cache[m] = period_;
+  }
+
+  long long period() const {
+    return period_;
+  }
+
+  template<typename Q>
+  int nth(Q n) const {
+    return fib(n % period_, m_);
+  }
+
+  template<int B>
+  int nth(const _bigint<B>& n) const {
+    if (period_ < (1 << 30)) {
+      return fib(n % static_cast<int>(period_), m_);
+    }
+    // Too wide for _bigint::operator%(int), reduce the decimal digits.
+    std::string s = n;
+    long long r = 0;
+    for (unsigned i = 0; i < s.size(); i++) {
+      r = (r * 10 + s[i] - '0') % period_;
+    }
+    return fib(r, m_);
+  }
+
+ private:
+  static std::map<int, long long>& periods() {
+    static std::map<int, long long> cache;
+    return cache;
+  }
+
+  static std::mutex& cache_mutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  // F(n) and F(n + 1) modulo m by fast doubling.
+  static void fib(long long n, long long m, long long& a, long long& b) {
+    a = 0;
+    b = 1 % m;
+    long long mask = 1;
+    while (mask <= n / 2) {
+      mask <<= 1;
+    }
+    for (; n && mask; mask >>= 1) {
+      long long c = a * ((2 * b - a + m) % m) % m;
+      long long d = (a * a + b * b) % m;
+      if (n & mask) {
+        a = d;
+        b = (c + d) % m;
+      } else {
+        a = c;
+        b = d;
+      }
+    }
+  }
+
+  static int fib(long long n, long long m) {
+    long long a, b;
+    fib(n, m, a, b);
+    return a;
+  }
+
+  static long long prime_period(long long p, const std::vector<int>& primes) {
+    if (p == 2) return 3;
+    if (p == 5) return 20;
+    long long period = p % 5 == 1 || p % 5 == 4 ? p - 1 : 2 * (p + 1);
+    factorize(period, primes, [&](long long q, int e) {
+      long long a, b;
+      for (; e && period % q == 0; e--) {
+        fib(period / q, p, a, b);
+        if (a != 0 || b != 1) break;
+        period /= q;
+      }
+    });
+    return period;
+  }
+
+  int m_;
+  long long period_;
+};
@@ -0,0 +1,28 @@
+#include <string>
+#include "bench.h"
+#include "pisano.h"
+
+// Periods are cached per modulus, so every iteration uses a new one.
+BENCH(Period, 1000000, 1000000000) {
+  int m = state.arg();
+  while (state.run()) {
+    do_not_optimize(pisano(m++).period());
+  }
+}
+
+BENCH(NthLongLong, 1000, 1000000007) {
+  pisano fib(state.arg());
+  long long n = 1000000000000000000LL;
+  while (state.run()) {
+    do_not_optimize(fib.nth(n++));
+  }
+}
+
+// Index with 1000 digits, reduced modulo the period first.
+BENCH(NthBigint, 1000, 1000000007) {
+  pisano fib(state.arg());
+  bigint n("7" + std::string(999, '3'));
+  while (state.run()) {
+    do_not_optimize(fib.nth(n));
+  }
+}
@@ -0,0 +1,66 @@
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "pisano.h"
+
+TEST(PisanoTest, Period) {
+  int m[10] = {1, 2, 3, 5, 7, 10, 11, 100, 1000, 1000000007};
+  long long period[10] = {1, 3, 8, 20, 16, 60, 10, 300, 1500, 2000000016};
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(period[i], pisano(m[i]).period());
+  }
+}
+
+TEST(PisanoTest, SmallIndices) {
+  pisano fib(1000);
+  int ans[16] = {0, 1, 1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 377, 610};
+  for (int i = 0; i < 16; i++) {
+    EXPECT_EQ(ans[i], fib.nth(i));
+  }
+  EXPECT_EQ(597, fib.nth(17));
+}
+
+TEST(PisanoTest, MatchesIteration) {
+  int m[4] = {2, 12, 97, 1024};
+  for (int k = 0; k < 4; k++) {
+    pisano fib(m[k]);
+    int a = 0, b = 1 % m[k];
+    for (long long i = 0; i < 5000; i++) {
+      EXPECT_EQ(a, fib.nth(i));
+      int c = (a + b) % m[k];
+      a = b;
+      b = c;
+    }
+  }
+}
+
+TEST(PisanoTest, Bigint) {
+  pisano fib(1000);
+  // The period of 1000 is 1500, and 10^100 = 1000 (mod 1500).
+  bigint n("1" + std::string(100, '0'));
+  EXPECT_EQ(fib.nth(static_cast<long long>(n % 1500)), fib.nth(n));
+  EXPECT_EQ(fib.nth(1000LL), fib.nth(n));
+  // Period wider than 2^30 goes through the decimal path.
+  pisano wide(1000000007);
+  EXPECT_EQ(wide.nth(1000000000000LL % 2000000016LL),
+            wide.nth(bigint("1000000000000")));
+  EXPECT_EQ(0, wide.nth(bigint("2000000016")));
+}
+
+TEST(PisanoTest, SharedBetweenThreads) {
+  std::vector<std::thread> threads;
+  std::vector<int> wrong(4);
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([&wrong, t] {
+      for (int m = 2000 + t; m < 4000; m += 2) {
+        pisano fib(m);
+        wrong[t] += fib.nth(fib.period()) != 0 ||
+            fib.nth(fib.period() + 1) != 1;
+      }
+    }));
+  }
+  for (int t = 0; t < 4; t++) {
+    threads[t].join();
+  }
+  EXPECT_EQ(std::vector<int>(4), wrong);
+}
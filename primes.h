@@ -2,11 +2,13 @@
 #include <functional>
 #include <cmath>
 #include <vector>
+#include "instrument.h"
 
-//reserve sieve getprimes factorize sum_of_divisors gcd totient
+//reserve sieve getprimes factorize sum_of_divisors gcd totient static_sieve
 
 template<typename PrimeCallback>
 std::vector<bool> sieve(int maxprime, PrimeCallback callback) {
+  INSTRUMENT_TIMER("primes.sieve");
   std::vector<bool> primes(1 + maxprime, true);
   primes[0] = primes[1] = false;
   int i = 2;
@@ -40,8 +42,75 @@ std::vector<int> getprimes(int maxprime) {
   return primes;
 }
 
+template<int N>
+constexpr int count_primes() {
+  bool composite[N + 1] = {};
+  int count = 0;
+  for (int i = 2; i <= N; i++) {
+    if (!composite[i]) {
+      count++;
+      for (long long j = 1LL * i * i; j <= N; j += i) {
+        composite[j] = true;
+      }
+    }
+  }
+  return count;
+}
+
+// Sieve run by the compiler: a constexpr instance is stored in the binary
+// and costs nothing at startup, e.g. constexpr static_sieve<100000> primes;
+// Compilers bound the work in a constant expression (gcc allows 2^18
+// iterations per loop by default), so N should stay around 10^5. Can be
+// passed to factorize() in place of getprimes(). Requires N >= 2.
+template<int N>
+class static_sieve {
+ public:
+  static constexpr int COUNT = count_primes<N>();
+
+  constexpr static_sieve() : composite_(), primes_() {
+    composite_[0] = composite_[1] = true;
+    int count = 0;
+    for (int i = 2; i <= N; i++) {
+      if (!composite_[i]) {
+        primes_[count++] = i;
+        for (long long j = 1LL * i * i; j <= N; j += i) {
+          composite_[j] = true;
+        }
+      }
+    }
+  }
+
+  constexpr bool is_prime(int n) const {
+    return !composite_[n];
+  }
+
+  constexpr int size() const {
+    return COUNT;
+  }
+
+  constexpr int operator[](int i) const {
+    return primes_[i];
+  }
+
+  constexpr const int* begin() const {
+    return primes_;
+  }
+
+  constexpr const int* end() const {
+    return primes_ + COUNT;
+  }
+
+ private:
+  bool composite_[N + 1];
+  int primes_[COUNT];
+};
+
+template<int N>
+constexpr int static_sieve<N>::COUNT;
+
 
 void divmod(int a, int b, int& div, int& mod) {
+  INSTRUMENT_COUNT("primes.divmod", 1);
   asm (
     "idivl %%esi\n\t"
     : "=d" (mod), "=a" (div)
@@ -50,11 +119,10 @@ void divmod(int a, int b, int& div, int& mod) {
   );
 }
 
-template <typename FactorCallback, typename T>
-void factorize(T number, const std::vector<int>& primes,
-               FactorCallback factor) {
+template <typename FactorCallback, typename T, typename Primes>
+void factorize(T number, const Primes& primes, FactorCallback factor) {
   int maxp = static_cast<int>(sqrt(number));
-  for (int i = 0; primes[i] <= maxp; i++) {
+  for (int i = 0; i < int(primes.size()) && primes[i] <= maxp; i++) {
     if (number % primes[i] == 0) {
       int fac = 1;
       number /= primes[i];
@@ -0,0 +1,45 @@
+#include <vector>
+#include "bench.h"
+#include "primes.h"
+
+BENCH(Sieve, 1 << 16, 1 << 20, 1 << 24) {
+  while (state.run()) {
+    do_not_optimize(sieve(state.arg()));
+  }
+}
+
+BENCH(GetPrimes, 1 << 16, 1 << 20, 1 << 24) {
+  while (state.run()) {
+    do_not_optimize(getprimes(state.arg()));
+  }
+}
+
+// Trial division over the primes up to sqrt(n), for n in [arg, arg + 1024).
+BENCH(Factorize, 1 << 20, 1 << 30) {
+  std::vector<int> primes = getprimes(1 << 16);
+  int i = 0;
+  while (state.run()) {
+    int sum = 0;
+    factorize(int(state.arg()) + (i++ & 1023), primes, [&sum](int p, int e) {
+      sum += p * e;
+    });
+    do_not_optimize(sum);
+  }
+}
+
+BENCH(Totient, 1 << 20, 1 << 30) {
+  std::vector<int> primes = getprimes(1 << 16);
+  int i = 0;
+  while (state.run()) {
+    do_not_optimize(totient<long long>(int(state.arg()) + (i++ & 1023),
+                                       primes));
+  }
+}
+
+BENCH(Gcd, 1) {
+  long long a = 1000000007LL * 998244353, b = 1000000009LL * 998244353;
+  while (state.run()) {
+    do_not_optimize(gcd(a, b));
+    a++;
+  }
+}
@@ -76,4 +76,19 @@ TEST(PrimesTest, LargeTotient) {
   EXPECT_EQ(42, totient<int>(49, primes));
 }
 
-
+TEST(PrimesTest, StaticSieve) {
+  static_assert(static_sieve<100>::COUNT == 25, "count");
+  static_assert(static_sieve<100>().is_prime(97), "97");
+  constexpr static static_sieve<100000> table;
+  vector<int> primes = getprimes(100000);
+  ASSERT_EQ(int(primes.size()), table.size());
+  EXPECT_TRUE(equal(primes.begin(), primes.end(), table.begin()));
+  for (int i = 0; i <= 100000; i += 7) {
+    EXPECT_EQ(binary_search(primes.begin(), primes.end(), i),
+              table.is_prime(i));
+  }
+  Accumulate acc;
+  factorize(2 * 2 * 99991, table, acc);
+  int f[] = {2, 2, 99991, 1};
+  EXPECT_TRUE(equal(acc.acc.begin(), acc.acc.end(), f));
+}